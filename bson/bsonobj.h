@@ -314,7 +314,8 @@ namespace mongo {
             opELEM_MATCH = 0x12,
             opNEAR = 0x13,
             opWITHIN = 0x14,
-            opMAX_DISTANCE=0x15
+            opMAX_DISTANCE=0x15,
+            opTEXT=0x16
         };               
 
         /** add all elements of the object to the specified vector */
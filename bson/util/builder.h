@@ -49,11 +49,23 @@ namespace mongo {
 
     void msgasserted(int msgid, const char *msg);
 
+    /* where a BufBuilder gets its memory when it shouldn't be malloc() - e.g. a buffer pool.
+       a decouple()d buffer then has to be given back with release() of the same allocator, not free().
+    */
+    class BufAllocator {
+    public:
+        virtual ~BufAllocator() {}
+        virtual char* get( int size ) = 0;
+        /* like realloc() */
+        virtual char* grow( char *buf , int oldSize , int newSize ) = 0;
+        virtual void release( char *buf ) = 0;
+    };
+
     class BufBuilder {
     public:
-        BufBuilder(int initsize = 512) : size(initsize) {
+        BufBuilder(int initsize = 512, BufAllocator *alloc = 0) : size(initsize), _alloc(alloc) {
             if ( size > 0 ) {
-                data = (char *) malloc(size);
+                data = _alloc ? _alloc->get(size) : (char *) malloc(size);
                 if( data == 0 )
                     msgasserted(10000, "out of memory BufBuilder");
             } else {
@@ -67,7 +79,10 @@ namespace mongo {
 
         void kill() {
             if ( data ) {
-                free(data);
+                if ( _alloc )
+                    _alloc->release(data);
+                else
+                    free(data);
                 data = 0;
             }
         }
@@ -75,8 +90,8 @@ namespace mongo {
         void reset( int maxSize = 0 ){
             l = 0;
             if ( maxSize && size > maxSize ){
-                free(data);
-                data = (char*)malloc(maxSize);
+                kill();
+                data = _alloc ? _alloc->get(maxSize) : (char*)malloc(maxSize);
                 size = maxSize;
             }            
         }
@@ -88,9 +103,11 @@ namespace mongo {
         char* buf() { return data; }
         const char* buf() const { return data; }
 
-        /* assume ownership of the buffer - you must then free() it */
+        /* assume ownership of the buffer - you must then free() it (or release() it to allocator()) */
         void decouple() { data = 0; }
 
+        BufAllocator* allocator() const { return _alloc; }
+
         void appendChar(char j){
             *((char*)grow(sizeof(char))) = j;
         }
@@ -157,13 +174,17 @@ namespace mongo {
                 a = l + 16 * 1024;
             if ( a > BufferMaxSize )
                 msgasserted(10000, "BufBuilder grow() > 64MB");
-            data = (char *) realloc(data, a);
+            if ( _alloc )
+                data = _alloc->grow(data, size, a);
+            else
+                data = (char *) realloc(data, a);
             size= a;
         }
 
         char *data;
         int l;
         int size;
+        BufAllocator *_alloc;
 
         friend class StringBuilder;
     };
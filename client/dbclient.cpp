@@ -246,6 +246,21 @@ namespace mongo {
 		return info;
     }
 
+    BSONObj DBClientWithCommands::getLastErrorDetailed( bool fsync , int w , int wtimeout ) { 
+        BSONObjBuilder b;
+        b.append( "getlasterror" , 1 );
+        if ( fsync )
+            b.append( "fsync" , 1 );
+        if ( w > 1 )
+            b.append( "w" , w );
+        if ( wtimeout > 0 )
+            b.append( "wtimeout" , wtimeout );
+
+        BSONObj info;
+        runCommand( "admin" , b.obj() , info );
+        return info;
+    }
+
     string DBClientWithCommands::getLastError() { 
         BSONObj info = getLastErrorDetailed();
         return getLastErrorString( info );
@@ -494,6 +509,7 @@ namespace mongo {
     }
 
     bool DBClientConnection::_connect( string& errmsg ){
+        _failPending(); // their replies would have come on the old socket
         _serverString = _server.toString();
         // we keep around SockAddr for connection life -- maybe MessagingPort
         // requires that?
@@ -512,9 +528,85 @@ namespace mongo {
             failed = true;
             return false;
         }
+
+        if ( _localSocket && server->isLocalHost() )
+            _switchToLocalSocket();
+
+        if ( ( _compression || cmdLine.networkCompression ) && ! onLocalSocket() )
+            _negotiateCompression();
         return true;
     }
 
+    void DBClientConnection::setLocalSocket( bool on ) {
+        _localSocket = on;
+        // switching drops the tcp socket, so not with replies outstanding or auth done on it
+        if ( on && p.get() && ! failed && _pending.empty() && authCache.empty() && server->isLocalHost() )
+            _switchToLocalSocket();
+    }
+
+    void DBClientConnection::_switchToLocalSocket() {
+        if ( onLocalSocket() )
+            return;
+        BSONObj info;
+        bool master;
+        try {
+            isMaster( master , &info );
+        }
+        catch ( DBException& e ) {
+            log(_logLevel) << "couldn't check unix socket of " << _serverString << ' ' << e.what() << endl;
+            return;
+        }
+        if ( info["unixSocket"].type() != String )
+            return;
+        string path = info["unixSocket"].String();
+
+        boost::scoped_ptr<SockAddr> addr( new SockAddr( path.c_str() , _server.port() ) );
+        boost::scoped_ptr<MessagingPort> port( new MessagingPort( _so_timeout, _logLevel ) );
+        if ( addr->getType() != AF_UNIX || ! port->connect( *addr ) ) {
+            log(_logLevel) << "couldn't connect to " << _serverString << " through " << path << ", staying on tcp" << endl;
+            return;
+        }
+
+        server.swap( addr );
+        p.swap( port );
+        log(1) << "connected to " << _serverString << " through " << path << endl;
+    }
+
+    void DBClientConnection::setCompression( bool on ) {
+        _compression = on;
+        if ( p.get() == 0 || failed )
+            return;
+        if ( on )
+            _negotiateCompression();
+        else
+            p->setCompression( false );
+    }
+
+    void DBClientConnection::_negotiateCompression() {
+        if ( ! compressionSupported() )
+            return;
+        BSONObj info;
+        bool master;
+        try {
+            isMaster( master , &info );
+        }
+        catch ( DBException& e ) {
+            log(_logLevel) << "couldn't check compression support of " << _serverString << ' ' << e.what() << endl;
+            return;
+        }
+        if ( info["compression"].type() != Array )
+            return;
+        BSONObjIterator i( info["compression"].embeddedObject() );
+        while ( i.more() ) {
+            BSONElement e = i.next();
+            if ( e.type() == String && strcmp( e.valuestr() , "zlib" ) == 0 ) {
+                p->setCompression( true );
+                log(1) << "compressing connection to " << _serverString << endl;
+                return;
+            }
+        }
+    }
+
     void DBClientConnection::_checkConnection() {
         if ( !failed )
             return;
@@ -836,6 +928,31 @@ namespace mongo {
     }
 
     bool DBClientConnection::call( Message &toSend, Message &response, bool assertOk ) {
+        if ( ! _pending.empty() ) {
+            // replies to the pipelined requests come first
+            try {
+                say( toSend );
+            }
+            catch ( SocketException& ) {
+                _failPending();
+                throw;
+            }
+            MSGID id = toSend.header()->id;
+            while ( 1 ) {
+                Message m;
+                if ( ! _recvReply( m ) ) {
+                    if ( assertOk )
+                        uasserted( 10278 , str::stream() << "dbclient error communicating with server: " << getServerAddress() );
+                    return false;
+                }
+                if ( m.header()->responseTo == id ) {
+                    response = m;
+                    return true;
+                }
+                _dispatchReply( m );
+            }
+        }
+
         /* todo: this is very ugly messagingport::call returns an error code AND can throw 
                  an exception.  we should make it return void and just throw an exception anytime 
                  it fails
@@ -855,6 +972,104 @@ namespace mongo {
         return true;
     }
 
+    shared_ptr<PendingReply> DBClientConnection::callAsync( Message& toSend ) {
+        while ( (int) _pending.size() >= _maxInFlight ) {
+            shared_ptr<PendingReply> oldest = _pending.front();
+            oldest->join();
+        }
+        try {
+            say( toSend );
+        }
+        catch ( SocketException& ) {
+            _failPending();
+            throw;
+        }
+        shared_ptr<PendingReply> r( new PendingReply( this , toSend.header()->id ) );
+        _pending.push_back( r );
+        return r;
+    }
+
+    shared_ptr<PendingReply> DBClientConnection::runCommandAsync( const string& dbname , const BSONObj& cmd , int options ) {
+        Message toSend;
+        assembleRequest( dbname + ".$cmd" , cmd , -1 , 0 , 0 , options , toSend );
+        return callAsync( toSend );
+    }
+
+    bool DBClientConnection::_recvReply( Message& m ) {
+        bool ok = false;
+        try {
+            ok = port().recv( m );
+        }
+        catch ( SocketException& ) {
+        }
+        if ( ! ok ) {
+            failed = true;
+            _failPending();
+        }
+        return ok;
+    }
+
+    void DBClientConnection::_dispatchReply( Message& m ) {
+        MSGID to = m.header()->responseTo;
+        for ( deque< shared_ptr<PendingReply> >::iterator i = _pending.begin(); i != _pending.end(); ++i ) {
+            PendingReply *r = i->get();
+            if ( r->_id == to ) {
+                r->_reply = m;
+                r->_done = true;
+                r->_ok = true;
+                r->_conn = 0;
+                _pending.erase( i );
+                return;
+            }
+        }
+        log() << "reply to unknown request " << (unsigned) to << " from " << _serverString << endl;
+        failed = true;
+        _failPending();
+        throw SocketException( SocketException::RECV_ERROR );
+    }
+
+    void DBClientConnection::_waitFor( PendingReply *r ) {
+        while ( ! r->_done ) {
+            Message m;
+            if ( ! _recvReply( m ) )
+                throw SocketException( SocketException::RECV_ERROR );
+            _dispatchReply( m );
+        }
+    }
+
+    void DBClientConnection::_failPending() {
+        for ( deque< shared_ptr<PendingReply> >::iterator i = _pending.begin(); i != _pending.end(); ++i ) {
+            PendingReply *r = i->get();
+            r->_done = true;
+            r->_ok = false;
+            r->_conn = 0;
+        }
+        _pending.clear();
+    }
+
+    bool PendingReply::join() {
+        if ( ! _done ) {
+            try {
+                _conn->_waitFor( this );
+            }
+            catch ( SocketException& ) {
+            }
+        }
+        return _ok;
+    }
+
+    Message& PendingReply::reply() {
+        uassert( 13538 , "no reply, connection failed" , join() );
+        return _reply;
+    }
+
+    BSONObj PendingReply::result() {
+        QueryResult *qr = (QueryResult *) reply().singleData();
+        if ( qr->nReturned == 0 )
+            return BSONObj();
+        return BSONObj( qr->data() ).getOwned();
+    }
+
     void DBClientConnection::checkResponse( const char *data, int nReturned ) {
         /* check for errors.  the only one we really care about at
          this stage is "not master" */
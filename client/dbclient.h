@@ -452,6 +452,15 @@ namespace mongo {
 		*/
 		virtual BSONObj getLastErrorDetailed();
 
+        /** Get error result from the last operation on this connection, after waiting for it (and so 
+            every write before it on this connection) to be on w servers, and flushed to disk if fsync.
+            Do a batch of writes and then one of these to wait for all of them at once.
+            @param wtimeout milliseconds to wait for w, 0 for no limit.  the result has wtimeout:true 
+                   if it ran out.
+            @return full error object.
+         */
+        BSONObj getLastErrorDetailed( bool fsync , int w , int wtimeout = 0 );
+
         static string getLastErrorString( const BSONObj& res );
 
         /** Return the last error which has occurred, even if not the very last operation.
@@ -675,11 +684,12 @@ namespace mongo {
             return ns.substr( pos + 1 );            
         }
 
+        /** the QueryOption flags the server supports (cached per connection) */
+        enum QueryOptions availableOptions();
+
     protected:
         bool isOk(const BSONObj&);
         
-        enum QueryOptions availableOptions();
-        
     private:
         enum QueryOptions _cachedAvailableOptions;
         bool _haveCachedAvailableOptions;
@@ -774,6 +784,38 @@ namespace mongo {
         ConnectException(string msg) : UserException(9000,msg) { }
     };
 
+    class DBClientConnection;
+
+    /**
+       The reply to a request sent with DBClientConnection::callAsync(), which may not have arrived yet.
+       Replies are read off the connection when someone waits for one, so a PendingReply must be 
+       used from the thread that owns its connection.
+    */
+    class PendingReply : boost::noncopyable {
+    public:
+        bool isDone() const { return _done; }
+
+        /** blocks until the reply has arrived, reading the replies to earlier requests on the way
+            @return false if the connection failed first */
+        bool join();
+
+        /** the reply message, join()s first.  throws if there is no reply */
+        Message& reply();
+
+        /** for a query or command: the first document returned, join()s first.  throws if there is no reply */
+        BSONObj result();
+
+    private:
+        friend class DBClientConnection;
+        PendingReply( DBClientConnection *conn , MSGID id ) : _conn( conn ), _id( id ), _done( false ), _ok( false ) { }
+
+        DBClientConnection *_conn; // 0 once done
+        const MSGID _id;
+        bool _done;
+        bool _ok;
+        Message _reply;
+    };
+
     /** 
         A basic connection to the database. 
         This is the main entry point for talking to a simple Mongo setup
@@ -787,7 +829,10 @@ namespace mongo {
            Connect timeout is fixed, but short, at 5 seconds.
          */
         DBClientConnection(bool _autoReconnect=false, DBClientReplicaSet* cp=0, double so_timeout=0) :
-                clientSet(cp), failed(false), autoReconnect(_autoReconnect), lastReconnectTry(0), _so_timeout(so_timeout) { }
+                clientSet(cp), failed(false), autoReconnect(_autoReconnect), lastReconnectTry(0), _so_timeout(so_timeout),
+                _compression(false), _localSocket(false), _maxInFlight(64) { }
+
+        virtual ~DBClientConnection() { _failPending(); }
 
         /** Connect to a Mongo database server.
 
@@ -856,6 +901,39 @@ namespace mongo {
 
         MessagingPort& port() { return *p; }
 
+        /** compress the traffic on this connection if the server supports it (see isMaster's compression field).
+            takes effect right away if connected, and for reconnects.  --networkCompression turns this on for 
+            every connection a server makes.
+         */
+        void setCompression( bool on );
+        bool compressing() const { return p && p->compressing(); }
+
+        /** when the server is on this host and listens on a unix domain socket (see isMaster's 
+            unixSocket field), talk to it over that instead of tcp.  skips the tcp/ip stack on both 
+            ends, which helps bulk readers like mongodump.  takes effect right away if connected 
+            with nothing in flight and no auth() done yet, and for reconnects.
+         */
+        void setLocalSocket( bool on );
+        bool onLocalSocket() const { return server && server->getType() == AF_UNIX; }
+
+        /** Sends a request without waiting for its reply, so that several requests can be in flight
+            on this connection at once; the server answers them in the order it got them.
+            The returned PendingReply is completed when its reply is read, either by join()ing it or 
+            by a later join() or call() on this connection.  If maxInFlight() requests are already 
+            outstanding, waits for the oldest one first.
+            Don't mix with exhaust queries.
+         */
+        shared_ptr<PendingReply> callAsync( Message& toSend );
+
+        /** runCommand() without waiting for the result, see callAsync().  PendingReply::result() is 
+            the command's result object.
+         */
+        shared_ptr<PendingReply> runCommandAsync( const string& dbname , const BSONObj& cmd , int options = 0 );
+
+        void setMaxInFlight( int n ) { assert( n > 0 ); _maxInFlight = n; }
+        int maxInFlight() const { return _maxInFlight; }
+        int inFlight() const { return _pending.size(); }
+
         string toStringLong() const {
             stringstream ss;
             ss << _serverString;
@@ -896,7 +974,19 @@ namespace mongo {
 
 		map< string, pair<string,string> > authCache;
         const double _so_timeout;        
+        bool _compression;
+        bool _localSocket;
         bool _connect( string& errmsg );
+        void _negotiateCompression();
+        void _switchToLocalSocket();
+
+        friend class PendingReply;
+        deque< shared_ptr<PendingReply> > _pending; // in the order sent
+        int _maxInFlight;
+        bool _recvReply( Message& m ); // false if the connection failed, which fails all pending replies
+        void _dispatchReply( Message& m );
+        void _waitFor( PendingReply *r );
+        void _failPending();
     };
     
     /** Use this class to connect to a replica set of servers.  The class will manage
@@ -990,6 +1080,12 @@ namespace mongo {
 
     protected:                
         virtual void sayPiggyBack( Message &toSend ) { checkMaster()->say( toSend ); }
+
+        /** the rest of an exhaust query's reply comes from the master the query went to */
+        virtual void recv( Message& m ) {
+            uassert( 13544 , "replica set master changed during exhaust query" , _currentMaster && ! _currentMaster->isFailed() );
+            static_cast<DBConnector*>( _currentMaster )->recv( m );
+        }
         
         bool isFailed() const {
             return _currentMaster == 0 || _currentMaster->isFailed();
@@ -114,9 +114,9 @@ namespace mongo {
                 throw UserException( 13127 , "getMore: cursor didn't exist on server, possible restart or timeout?" );
         }
         
-        if ( cursorId == 0 || ! ( opts & QueryOption_CursorTailable ) ) {
+        if ( cursorId == 0 || ! ( opts & QueryOption_CursorTailable ) || ( opts & QueryOption_Exhaust ) ) {
             // only set initially: we don't want to kill it on end of data
-            // if it's a tailable cursor
+            // if it's a tailable cursor.  but an exhaust stream ends there, nothing more will come
             cursorId = qr->cursorId;
         }
 
@@ -146,7 +146,10 @@ namespace mongo {
         if ( cursorId == 0 )
             return false;
 
-        requestMore();
+        if ( opts & QueryOption_Exhaust )
+            exhaustReceiveMore(); // the server sends the next batch without being asked
+        else
+            requestMore();
         return pos < nReturned;
     }
 
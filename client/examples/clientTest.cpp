@@ -208,6 +208,46 @@ int main( int argc, const char **argv ) {
         assert( conn.getLastError().empty() );
     }
 
+    { // pipelined requests
+        conn.dropCollection( ns );
+        for ( int i=0; i<10; i++ )
+            conn.insert( ns , BSON( "x" << i ) );
+
+        vector< shared_ptr<PendingReply> > counts;
+        for ( int i=0; i<10; i++ )
+            counts.push_back( conn.runCommandAsync( "test" , BSON( "count" << "test1" << "query" << BSON( "x" << GTE << i ) ) ) );
+        assert( conn.inFlight() == 10 );
+
+        // a blocking call in between reads the replies ahead of its own
+        assert( conn.findOne( ns , BSONObj() )["x"].isNumber() );
+        assert( conn.inFlight() == 0 );
+        for ( int i=0; i<10; i++ ){
+            assert( counts[i]->isDone() );
+            assert( counts[i]->result()["n"].number() == 10 - i );
+        }
+
+        conn.setMaxInFlight( 3 );
+        counts.clear();
+        for ( int i=0; i<10; i++ ){
+            counts.push_back( conn.runCommandAsync( "test" , BSON( "count" << "test1" ) ) );
+            assert( conn.inFlight() <= 3 );
+        }
+        for ( int i=9; i>=0; i-- )
+            assert( counts[i]->result()["n"].number() == 10 );
+        assert( conn.inFlight() == 0 );
+    }
+
+    { // unix socket to a local server
+        DBClientConnection local;
+        local.setLocalSocket( true );
+        assert( local.connect( string( "127.0.0.1:" ) + port , errmsg ) );
+        BSONObj info;
+        bool master;
+        local.isMaster( master , &info );
+        assert( local.onLocalSocket() == ( info["unixSocket"].type() == String ) );
+        assert( local.count( ns ) == 10 );
+    }
+
     {
         list<string> l = conn.getDatabaseNames();
         for ( list<string>::iterator i = l.begin(); i != l.end(); i++ ){
@@ -31,7 +31,7 @@ namespace mongo {
     ClusteredCursor::ClusteredCursor( QueryMessage& q ){
         _ns = q.ns;
         _query = q.query.copy();
-        _options = q.queryOptions;
+        _options = q.queryOptions & ~QueryOption_Exhaust; // the shard cursors getMore over pooled connections
         _fields = q.fields.copy();
         _batchSize = q.ntoreturn;
         if ( _batchSize == 1 )
@@ -315,6 +315,226 @@ namespace mongo {
         }
     }
 
+    // --------  ParallelFeeds -----------
+
+    ParallelFeeds::ParallelFeeds()
+        : _mutex( "ParallelFeeds" ) , _waitingForFirst( 0 ) , _fetching( 0 ) , _stop( false ) , 
+          _error( false ) , _errorCode( 0 ) , _errorStale( false ) , _errorJustConnection( false ){
+    }
+
+    ParallelFeeds::~ParallelFeeds(){
+        // a fetch in the middle of a round trip finishes it first, queued ones return right away
+        scoped_lock lk( _mutex );
+        _stop = true;
+        while ( _fetching > 0 )
+            _gotResults.wait( lk.boost() );
+    }
+
+    static mongo::mutex parallelFeedsPoolMutex( "ParallelFeeds::_pool" );
+    static ThreadPool * parallelFeedsPool = 0;
+
+    ThreadPool& ParallelFeeds::_pool(){
+        // made on first use, most processes that link this never run a parallel cursor
+        scoped_lock lk( parallelFeedsPoolMutex );
+        if ( ! parallelFeedsPool )
+            parallelFeedsPool = new ThreadPool( MaxFetchesInFlight );
+        return *parallelFeedsPool;
+    }
+
+    void ParallelFeeds::start( const set<ServerAndQuery>& servers , QueryFunc query ){
+        assert( _feeds.empty() );
+        _query = query;
+        for ( set<ServerAndQuery>::const_iterator i = servers.begin(); i!=servers.end(); ++i )
+            _feeds.push_back( shared_ptr<Feed>( new Feed( *i ) ) );
+
+        // all of them, even after an error, as the fetches use the cursor that owns us until then
+        scoped_lock lk( _mutex );
+        _waitingForFirst = _feeds.size();
+        for ( unsigned i=0; i<_feeds.size(); i++ )
+            _prefetch( i );
+        while ( _waitingForFirst > 0 )
+            _gotResults.wait( lk.boost() );
+        _checkError();
+    }
+
+    /* call with _mutex held.  keeps feed i at most one batch ahead of the taker */
+    void ParallelFeeds::_prefetch( int i ){
+        Feed& f = *_feeds[i];
+        if ( f.done || f.fetching || _stop )
+            return;
+        if ( ! f.results.empty() && f.results.size() >= (unsigned)f.lastBatch )
+            return;
+        f.fetching = true;
+        _fetching++;
+        _pool().schedule( &ParallelFeeds::_fetch , this , i );
+    }
+
+    void ParallelFeeds::_fetch( int i ){
+        Feed& f = *_feeds[i];
+        {
+            scoped_lock lk( _mutex );
+            if ( _stop ){
+                f.fetching = false;
+                _fetching--;
+                _gotResults.notify_all();
+                return;
+            }
+        }
+
+        // the cursor is ours until fetching is cleared
+        bool first = f.cursor.get() == 0;
+        vector<BSONObj> batch;
+        bool more = false;
+        try {
+            if ( first )
+                f.cursor = _query( f.server );
+
+            // after the first batch this is a getMore
+            more = f.cursor->more();
+            if ( more ){
+                do {
+                    batch.push_back( f.cursor->next().getOwned() );
+                } while ( f.cursor->moreInCurrentBatch() );
+            }
+        }
+        catch ( StaleConfigException& e ){
+            more = false;
+            scoped_lock lk( _mutex );
+            if ( ! _error ){
+                _error = _errorStale = true;
+                _errorJustConnection = e.justConnection();
+                _errorMsg = e.getns();
+            }
+        }
+        catch ( DBException& e ){
+            more = false;
+            scoped_lock lk( _mutex );
+            if ( ! _error ){
+                _error = true;
+                _errorCode = e.getCode();
+                _errorMsg = f.server._server + ": " + e.what();
+            }
+        }
+        catch ( std::exception& e ){
+            more = false;
+            scoped_lock lk( _mutex );
+            if ( ! _error ){
+                _error = true;
+                _errorMsg = f.server._server + ": " + e.what();
+            }
+        }
+
+        scoped_lock lk( _mutex );
+        f.results.insert( f.results.end() , batch.begin() , batch.end() );
+        f.lastBatch = batch.size();
+        if ( first )
+            _waitingForFirst--;
+        if ( ! more )
+            f.done = true;
+        f.fetching = false;
+        _fetching--;
+        _gotResults.notify_all();
+    }
+
+    /* call with _mutex held */
+    void ParallelFeeds::_checkError(){
+        if ( ! _error )
+            return;
+        if ( _errorStale )
+            throw StaleConfigException( _errorMsg , "ParallelFeeds" , _errorJustConnection );
+        throw UserException( _errorCode ? _errorCode : 13547 , _errorMsg );
+    }
+
+    bool ParallelFeeds::more( int i ){
+        Feed& f = *_feeds[i];
+        scoped_lock lk( _mutex );
+        while ( true ){
+            _checkError();
+            if ( ! f.results.empty() )
+                return true;
+            if ( f.done )
+                return false;
+            _prefetch( i );
+            _gotResults.wait( lk.boost() );
+        }
+    }
+
+    BSONObj ParallelFeeds::peek( int i ){
+        scoped_lock lk( _mutex );
+        assert( ! _feeds[i]->results.empty() );
+        return _feeds[i]->results.front();
+    }
+
+    BSONObj ParallelFeeds::next( int i ){
+        Feed& f = *_feeds[i];
+        scoped_lock lk( _mutex );
+        assert( ! f.results.empty() );
+        BSONObj o = f.results.front();
+        f.results.pop_front();
+        _prefetch( i );
+        return o;
+    }
+
+    int ParallelFeeds::any( int from ){
+        int n = _feeds.size();
+        scoped_lock lk( _mutex );
+        while ( true ){
+            _checkError();
+            bool allDone = true;
+            for ( int k=0; k<n; k++ ){
+                Feed& f = *_feeds[ ( from + k ) % n ];
+                if ( ! f.results.empty() )
+                    return ( from + k ) % n;
+                if ( ! f.done ){
+                    allDone = false;
+                    _prefetch( ( from + k ) % n );
+                }
+            }
+            if ( allDone )
+                return -1;
+            _gotResults.wait( lk.boost() );
+        }
+    }
+
+    // --------  ParallelUnorderedClusteredCursor -----------
+
+    ParallelUnorderedClusteredCursor::ParallelUnorderedClusteredCursor( const set<ServerAndQuery>& servers , QueryMessage& q )
+        : ClusteredCursor( q ) , _servers( servers ) , _current( 0 ){
+        _needToSkip = q.ntoskip;
+    }
+
+    void ParallelUnorderedClusteredCursor::_init(){
+        // each server has to return skip more than it would otherwise, we don't know which ones will be skipped
+        _feeds.start( _servers , boost::bind( &ParallelUnorderedClusteredCursor::queryServer , this , _1 , _needToSkip ) );
+    }
+
+    bool ParallelUnorderedClusteredCursor::more(){
+        while ( true ){
+            _current = _feeds.any( _current );
+            if ( _current < 0 ){
+                _current = 0;
+                return false;
+            }
+            if ( _needToSkip == 0 )
+                return true;
+            _feeds.next( _current );
+            _needToSkip--;
+        }
+    }
+    
+    BSONObj ParallelUnorderedClusteredCursor::next(){
+        uassert( 13548 , "no more items" , more() );
+        return _feeds.next( _current );
+    }
+
+    void ParallelUnorderedClusteredCursor::_explain( map< string,list<BSONObj> >& out ){
+        for ( set<ServerAndQuery>::iterator i=_servers.begin(); i!=_servers.end(); ++i ){
+            const ServerAndQuery& sq = *i;
+            list<BSONObj> & l = out[sq._server];
+            l.push_back( explain( sq._server , sq._extra ) );
+        }
+    }
+
     // --------  ParallelSortClusteredCursor -----------
     
     ParallelSortClusteredCursor::ParallelSortClusteredCursor( const set<ServerAndQuery>& servers , QueryMessage& q , 
@@ -336,7 +556,7 @@ namespace mongo {
 
     void ParallelSortClusteredCursor::_finishCons(){
         _numServers = _servers.size();
-        _cursors = 0;
+        _heapFilled = false;
 
         if ( ! _sortKey.isEmpty() && ! _fields.isEmpty() ){
             // we need to make sure the sort key is in the project
@@ -381,21 +601,26 @@ namespace mongo {
     }
     
     void ParallelSortClusteredCursor::_init(){
-        assert( ! _cursors );
-        _cursors = new FilteringClientCursor[_numServers];
-            
-        // TODO: parellize
-        int num = 0;
-        for ( set<ServerAndQuery>::iterator i = _servers.begin(); i!=_servers.end(); ++i ){
-            const ServerAndQuery& sq = *i;
-            _cursors[num++].reset( query( sq._server , 0 , sq._extra , _needToSkip ) );
-        }
-            
+        _heapFilled = false;
+        // every server at once, so the first result waits for the slowest server instead of all of them in turn
+        _feeds.start( _servers , boost::bind( &ParallelSortClusteredCursor::queryServer , this , _1 , _needToSkip ) );
     }
-    
-    ParallelSortClusteredCursor::~ParallelSortClusteredCursor(){
-        delete [] _cursors;
-        _cursors = 0;
+
+    bool ParallelSortClusteredCursor::HeadOrder::operator()( const Head& a , const Head& b ) const {
+        // std heaps keep the largest on top, so this is reversed.  ties go to the later server as before
+        int comp = a.first.woSortOrder( b.first , _sortKey , true );
+        return comp > 0 || ( comp == 0 && a.second < b.second );
+    }
+
+    void ParallelSortClusteredCursor::_fillHeap(){
+        if ( _heapFilled )
+            return;
+        _heapFilled = true;
+        for ( int i=0; i<_numServers; i++ ){
+            if ( _feeds.more( i ) )
+                _heap.push_back( Head( _feeds.peek( i ) , i ) );
+        }
+        make_heap( _heap.begin() , _heap.end() , HeadOrder( _sortKey ) );
     }
 
     bool ParallelSortClusteredCursor::more(){
@@ -412,40 +637,24 @@ namespace mongo {
             _needToSkip = n;
         }
         
-        for ( int i=0; i<_numServers; i++ ){
-            if ( _cursors[i].more() )
-                return true;
-        }
-        return false;
+        _fillHeap();
+        return ! _heap.empty();
     }
         
     BSONObj ParallelSortClusteredCursor::next(){
-        BSONObj best = BSONObj();
-        int bestFrom = -1;
-            
-        for ( int i=0; i<_numServers; i++){
-            if ( ! _cursors[i].more() )
-                continue;
-            
-            BSONObj me = _cursors[i].peek();
-
-            if ( best.isEmpty() ){
-                best = me;
-                bestFrom = i;
-                continue;
-            }
-                
-            int comp = best.woSortOrder( me , _sortKey , true );
-            if ( comp < 0 )
-                continue;
-                
-            best = me;
-            bestFrom = i;
+        _fillHeap();
+        uassert( 10019 ,  "no more elements" , ! _heap.empty() );
+
+        HeadOrder order( _sortKey );
+        pop_heap( _heap.begin() , _heap.end() , order );
+        int from = _heap.back().second;
+        _heap.pop_back();
+
+        BSONObj best = _feeds.next( from );
+        if ( _feeds.more( from ) ){
+            _heap.push_back( Head( _feeds.peek( from ) , from ) );
+            push_heap( _heap.begin() , _heap.end() , order );
         }
-        
-        uassert( 10019 ,  "no more elements" , ! best.isEmpty() );
-        _cursors[bestFrom].next();
-            
         return best;
     }
 
@@ -25,6 +25,7 @@
 #include "../db/dbmessage.h"
 #include "../db/matcher.h"
 #include "../util/concurrency/mvar.h"
+#include "../util/concurrency/thread_pool.h"
 
 namespace mongo {
 
@@ -90,6 +91,7 @@ namespace mongo {
         virtual void _init() = 0;
 
         auto_ptr<DBClientCursor> query( const string& server , int num = 0 , BSONObj extraFilter = BSONObj() , int skipLeft = 0 );
+        auto_ptr<DBClientCursor> queryServer( const ServerAndQuery& sq , int skipLeft ){ return query( sq._server , 0 , sq._extra , skipLeft ); }
         BSONObj explain( const string& server , BSONObj extraFilter = BSONObj() );
         
         static BSONObj _concatFilter( const BSONObj& filter , const BSONObj& extraFilter );
@@ -210,22 +212,112 @@ namespace mongo {
     };
 
 
+    /**
+     * runs a query on any number of servers at once, reading each server's results one batch ahead 
+     * of whoever is taking them.  each round trip is a task on a pool shared by all cursors, so an 
+     * idle cursor holds no thread, and at most MaxFetchesInFlight round trips run at a time
+     * used by the parallel cursors, which take results from the servers in their own order
+     */
+    class ParallelFeeds : boost::noncopyable {
+    public:
+        typedef boost::function< auto_ptr<DBClientCursor> ( const ServerAndQuery& ) > QueryFunc;
+
+        enum { MaxFetchesInFlight = 32 };
+
+        ParallelFeeds();
+        ~ParallelFeeds();
+
+        /** sends the query to every server and waits for all the first replies, throws the first error */
+        void start( const set<ServerAndQuery>& servers , QueryFunc query );
+
+        int size() const { return _feeds.size(); }
+
+        /**
+         * waits for server i's next result if there isn't one yet, throws if any server had an error
+         * @return false if server i has no more
+         */
+        bool more( int i );
+        BSONObj peek( int i );
+        BSONObj next( int i );
+
+        /** 
+         * waits until some server has a result, preferring 'from' and then the ones after it
+         * @return that server, -1 if they are all done
+         */
+        int any( int from = 0 );
+
+    private:
+        struct Feed {
+            Feed( const ServerAndQuery& sq ) : server( sq ) , done( false ) , fetching( false ) , lastBatch( 0 ){}
+            ServerAndQuery server;
+            auto_ptr<DBClientCursor> cursor; // only used by its fetch
+            deque<BSONObj> results;
+            bool done;
+            bool fetching; // a fetch is queued or running
+            int lastBatch; // size of the last batch read
+        };
+
+        void _fetch( int i ); // one round trip for feed i, on the pool
+        void _prefetch( int i ); // call with _mutex held
+        void _checkError();
+
+        static ThreadPool& _pool();
+
+        vector< shared_ptr<Feed> > _feeds;
+        QueryFunc _query;
+
+        // below guarded by _mutex
+        mongo::mutex _mutex;
+        boost::condition _gotResults; // for the taker, and the destructor waiting for the fetches
+        int _waitingForFirst; // feeds that haven't heard back from their server yet
+        int _fetching; // feeds with a fetch queued or running
+        bool _stop;
+
+        // the first error any feed got, rethrown to the taker
+        bool _error;
+        int _errorCode;
+        string _errorMsg;
+        bool _errorStale;
+        bool _errorJustConnection;
+    };
+
+    /**
+     * runs a query in parallel across any number of servers, for queries without a sort
+     * results are returned a batch at a time in the order they arrive, so servers are interleaved
+     */
+    class ParallelUnorderedClusteredCursor : public ClusteredCursor {
+    public:
+        ParallelUnorderedClusteredCursor( const set<ServerAndQuery>& servers , QueryMessage& q );
+        virtual bool more();
+        virtual BSONObj next();
+        virtual string type() const { return "ParallelUnordered"; }
+    protected:
+        void _init();
+
+        virtual void _explain( map< string,list<BSONObj> >& out );
+
+        set<ServerAndQuery> _servers;
+        ParallelFeeds _feeds;
+        int _current; // server we're taking results from
+        int _needToSkip;
+    };
+
     /**
      * runs a query in parellel across N servers
-     * sots
+     * sorts by merging the servers' sorted results through a heap
      */        
     class ParallelSortClusteredCursor : public ClusteredCursor {
     public:
         ParallelSortClusteredCursor( const set<ServerAndQuery>& servers , QueryMessage& q , const BSONObj& sortKey );
         ParallelSortClusteredCursor( const set<ServerAndQuery>& servers , const string& ns , 
                                      const Query& q , int options=0, const BSONObj& fields=BSONObj() );
-        virtual ~ParallelSortClusteredCursor();
         virtual bool more();
         virtual BSONObj next();
         virtual string type() const { return "ParallelSort"; }
     protected:
         void _finishCons();
         void _init();
+        void _fillHeap();
 
         virtual void _explain( map< string,list<BSONObj> >& out );
 
@@ -233,7 +325,18 @@ namespace mongo {
         set<ServerAndQuery> _servers;
         BSONObj _sortKey;
         
-        FilteringClientCursor * _cursors;
+        ParallelFeeds _feeds;
+
+        /** each server's next result and which server, smallest by _sortKey on top */
+        typedef pair<BSONObj,int> Head;
+        struct HeadOrder {
+            HeadOrder( const BSONObj& sortKey ) : _sortKey( sortKey ){}
+            bool operator()( const Head& a , const Head& b ) const;
+            BSONObj _sortKey;
+        };
+        vector<Head> _heap;
+        bool _heapFilled;
+
         int _needToSkip;
     };
 
@@ -0,0 +1,219 @@
+// admission.cpp
+
+/**
+*    Copyright (C) 2008 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pch.h"
+#include "admission.h"
+#include "dbmessage.h"
+#include "commands.h"
+#include "curop.h"
+#include "../util/time_support.h"
+
+namespace mongo {
+
+    Admission admission;
+
+    Admission::Pool::Pool() : _m("admission") , _limit(0) , _active(0) , _waiting(0) ,
+                              _admitted(0) , _queued(0) , _queueMicros(0) , _maxQueueMicros(0) {
+    }
+
+    void Admission::Pool::acquire() {
+        scoped_lock lk( _m );
+        _admitted++;
+        if ( _limit == 0 || _active < _limit ) {
+            _active++;
+            return;
+        }
+
+        unsigned long long start = curTimeMicros64();
+        CurOp *op = cc().curop();
+        op->setMessage( "waiting for admission" );
+        _waiting++;
+        while ( _limit && _active >= _limit ) {
+            boost::xtime xt;
+            boost::xtime_get( &xt , boost::TIME_UTC );
+            xt.nsec += 100 * 1000000; // wake up now and then to see if we were killed
+            if ( xt.nsec >= 1000000000 ) {
+                xt.nsec -= 1000000000;
+                xt.sec++;
+            }
+            _cond.timed_wait( lk.boost() , xt );
+
+            const char *interrupted = inShutdown() ? "interrupted at shutdown" : killCurrentOp.checkForInterruptNoAssert( false );
+            if ( *interrupted ) {
+                _waiting--;
+                uasserted( 13550 , str::stream() << "waiting for admission: " << interrupted );
+            }
+        }
+        _waiting--;
+        _active++;
+        op->setMessage( "" );
+
+        long long t = curTimeMicros64() - start;
+        _queued++;
+        _queueMicros += t;
+        if ( t > _maxQueueMicros )
+            _maxQueueMicros = t;
+    }
+
+    void Admission::Pool::release() {
+        scoped_lock lk( _m );
+        _active--;
+        _cond.notify_one();
+    }
+
+    void Admission::Pool::setLimit( int limit ) {
+        scoped_lock lk( _m );
+        _limit = limit;
+        _cond.notify_all();
+    }
+
+    int Admission::Pool::limit() const {
+        scoped_lock lk( _m );
+        return _limit;
+    }
+
+    void Admission::Pool::appendStats( BSONObjBuilder& b ) const {
+        scoped_lock lk( _m );
+        b.append( "limit" , _limit );
+        b.append( "active" , _active );
+        b.append( "waiting" , _waiting );
+        b.appendNumber( "admitted" , _admitted );
+        b.appendNumber( "queued" , _queued );
+        b.appendNumber( "queueMicros" , _queueMicros );
+        b.appendNumber( "maxQueueMicros" , _maxQueueMicros );
+    }
+
+    Admission::Admission() {
+    }
+
+    Admission::OpClass Admission::classify( Message& m ) {
+        int op = m.operation();
+        if ( op == dbGetMore )
+            return Reads;
+        if ( op == dbUpdate || op == dbInsert || op == dbDelete )
+            return Writes;
+        if ( op != dbQuery )
+            return Unthrottled;
+
+        DbMessage d( m );
+        const char *ns = d.getns();
+        if ( ! strstr( ns , ".$cmd" ) )
+            return Reads;
+        // currentOp, killOp and fsync unlock are how a jam gets looked at and cleared
+        if ( strstr( ns , ".$cmd.sys." ) )
+            return Unthrottled;
+
+        BSONObj cmd;
+        try {
+            QueryMessage q( d );
+            cmd = q.query;
+        }
+        catch ( AssertionException& ) {
+            // bad message, receivedQuery() will say so
+            return Unthrottled;
+        }
+        BSONElement e = cmd.firstElement();
+        if ( e.type() == Object && ( strcmp( e.fieldName() , "query" ) == 0 || strcmp( e.fieldName() , "$query" ) == 0 ) )
+            e = e.embeddedObject().firstElement();
+        if ( e.eoo() )
+            return Commands;
+
+        // drivers and the other set members must still be able to tell we're alive
+        if ( strcmp( e.fieldName() , "isMaster" ) == 0 || strcmp( e.fieldName() , "ismaster" ) == 0 ||
+             strcmp( e.fieldName() , "replSetHeartbeat" ) == 0 )
+            return Unthrottled;
+
+        Command *c = Command::findCommand( e.fieldName() );
+        if ( c == 0 )
+            return Commands;
+        if ( c->longRunning() )
+            return LongRunning; // some lock for themselves, so check before locktype()
+        if ( c->locktype() == Command::NONE )
+            return Unthrottled;
+        return Commands;
+    }
+
+    const char * Admission::name( OpClass c ) {
+        switch ( c ) {
+        case Reads: return "reads";
+        case Writes: return "writes";
+        case Commands: return "commands";
+        case LongRunning: return "longRunning";
+        default: return "unthrottled";
+        }
+    }
+
+    void Admission::setLimit( OpClass c , int limit ) {
+        assert( c >= 0 && c < NumClasses );
+        _pools[c].setLimit( limit );
+    }
+
+    int Admission::limit( OpClass c ) const {
+        assert( c >= 0 && c < NumClasses );
+        return _pools[c].limit();
+    }
+
+    void Admission::appendStats( BSONObjBuilder& b ) const {
+        for ( int i = 0; i < NumClasses; i++ ) {
+            BSONObjBuilder bb( b.subobjStart( name( (OpClass) i ) ) );
+            _pools[i].appendStats( bb );
+            bb.done();
+        }
+    }
+
+    Admission::Ticket::Ticket( Admission& a , OpClass c ) : _a( a ) , _c( c ) {
+        if ( _c != Unthrottled )
+            _a._pools[_c].acquire();
+    }
+
+    Admission::Ticket::~Ticket() {
+        if ( _c != Unthrottled )
+            _a._pools[_c].release();
+    }
+
+    class CmdAdmission : public Command {
+    public:
+        CmdAdmission() : Command( "admission" ) { }
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual LockType locktype() const { return NONE; }
+        virtual void help( stringstream &help ) const {
+            help << "show or change the per operation class concurrency limits (0 = unlimited)\n";
+            help << "{ admission : 1 , reads : 20 , writes : 0 , commands : 0 , longRunning : 2 }";
+        }
+        bool run(const string& dbname, BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl ){
+            for ( int i = 0; i < Admission::NumClasses; i++ ) {
+                BSONElement e = cmdObj[ Admission::name( (Admission::OpClass) i ) ];
+                if ( e.eoo() )
+                    continue;
+                if ( ! e.isNumber() || e.numberInt() < 0 ) {
+                    errmsg = str::stream() << "bad limit for " << Admission::name( (Admission::OpClass) i );
+                    return false;
+                }
+            }
+            for ( int i = 0; i < Admission::NumClasses; i++ ) {
+                BSONElement e = cmdObj[ Admission::name( (Admission::OpClass) i ) ];
+                if ( e.isNumber() )
+                    admission.setLimit( (Admission::OpClass) i , e.numberInt() );
+            }
+            admission.appendStats( result );
+            return true;
+        }
+    } cmdAdmission;
+
+} // namespace mongo
@@ -0,0 +1,94 @@
+// admission.h - limits how many operations of each kind run at once
+
+/**
+*    Copyright (C) 2008 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "../pch.h"
+
+namespace mongo {
+
+    class Message;
+    class BSONObjBuilder;
+
+    /**
+     * Every operation from a client takes a ticket from the pool for its class before
+     * assembleResponse() runs it, and gives it back when done.  With a limit on a pool, a flood of
+     * one kind of operation (long scans, map/reduce) queues up on its own instead of piling onto
+     * dbMutex in front of everything else.
+     *
+     * A limit of 0 means unlimited, which is the default.  Limits are set at startup with
+     * --admissionReads, --admissionWrites, --admissionCommands and --admissionLongRunning, or at
+     * runtime with { admission : 1 , reads : n , ... }.  Queue times are in serverStatus.admission.
+     *
+     * An op waiting for a ticket is already in currentOp, so it can be killed, and it gives up at
+     * shutdown.  Ops needed to see or fix a jam (currentOp, killOp, fsyncUnlock, isMaster,
+     * replSetHeartbeat) never wait.
+     */
+    class Admission : boost::noncopyable {
+    public:
+        enum OpClass { Reads = 0 , Writes , Commands , LongRunning , NumClasses ,
+                       Unthrottled = -1 /* killcursors, commands that take no lock */ };
+
+        Admission();
+
+        static OpClass classify( Message& m );
+        static const char * name( OpClass c );
+
+        void setLimit( OpClass c , int limit );
+        int limit( OpClass c ) const;
+
+        void appendStats( BSONObjBuilder& b ) const;
+
+        /** waits for and holds a ticket of a class for its lifetime.
+            throws if the op is killed or the server shuts down while waiting */
+        class Ticket : boost::noncopyable {
+        public:
+            Ticket( Admission& a , OpClass c );
+            ~Ticket();
+        private:
+            Admission& _a;
+            OpClass _c;
+        };
+
+    private:
+        class Pool : boost::noncopyable {
+        public:
+            Pool();
+            void acquire();
+            void release();
+            void setLimit( int limit );
+            int limit() const;
+            void appendStats( BSONObjBuilder& b ) const;
+        private:
+            mutable mongo::mutex _m;
+            boost::condition _cond;
+            int _limit;
+            int _active;
+            int _waiting;
+            long long _admitted;
+            long long _queued;            // admitted after waiting
+            long long _queueMicros;
+            long long _maxQueueMicros;
+        };
+
+        Pool _pools[NumClasses];
+    };
+
+    extern Admission admission;
+
+} // namespace mongo
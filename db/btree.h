@@ -454,12 +454,22 @@ namespace mongo {
         // set initial bucket
         void init();
 
+        // if we've moved to a new bucket, ask the os to start reading what the scan will touch next
+        void checkReadahead() {
+            if ( bucket != _readaheadBucket )
+                readahead();
+        }
+        void readahead();
+        enum { RecordReadaheadBytes = 1024 }; // we don't know record sizes without faulting them in
+        enum { ReadaheadMaxGap = 256 * 1024 }; // locs closer than this in a file are prefetched as one range
+
         // if afterKey is true, we want the first key with values of the keyBegin fields greater than keyBegin
         void advanceTo( const BSONObj &keyBegin, int keyBeginLen, bool afterKey, const vector< const BSONElement * > &keyEnd, const vector< bool > &keyEndInclusive );
         
         friend class BtreeBucket;
 
         set<DiskLoc> _dups;
+        DiskLoc _readaheadBucket; // last bucket readahead() was done for
         NamespaceDetails * const d;
         const int idxNo;        
         BSONObj startKey;
@@ -21,6 +21,8 @@
 #include "pdfile.h"
 #include "jsobj.h"
 #include "curop-inl.h"
+#include "cmdline.h"
+#include "../util/mmap.h"
 
 namespace mongo {
 
@@ -71,6 +73,8 @@ namespace mongo {
         keyOfs = 0;
         indexDetails.head.btree()->customLocate( bucket, keyOfs, startKey, 0, false, _boundsIterator->cmp(), _boundsIterator->inc(), _ordering, _direction, noBestParent );
         skipAndCheck();
+        if ( ok() )
+            checkReadahead();
         dassert( _dups.size() == 0 );
     }
 
@@ -102,6 +106,8 @@ namespace mongo {
         }        
         skipUnusedKeys( false );
         checkEnd();
+        if ( ok() )
+            checkReadahead();
     }
     
     void BtreeCursor::skipAndCheck() {
@@ -196,9 +202,84 @@ namespace mongo {
         } else {
             skipAndCheck();
         }
+        if ( ok() )
+            checkReadahead();
         return ok();
     }
 
+    /* adds one range per run of locs that are in the same file and no more than
+       maxGap bytes apart, so we make a few large madvise calls instead of one per record.
+       reading the gaps in between is cheaper than the extra calls and faults.
+    */
+    static void addClusteredRanges( vector<DiskLoc>& locs , int len , int maxGap , vector< pair<const char*,size_t> >& ranges ) {
+        if ( locs.empty() )
+            return;
+        sort( locs.begin() , locs.end() );
+        DiskLoc first = locs[0];
+        int last = first.getOfs();
+        for ( unsigned i=1; i<=locs.size(); i++ ) {
+            if ( i < locs.size() && locs[i].a() == first.a() &&
+                 locs[i].getOfs() - last <= maxGap ) {
+                last = locs[i].getOfs();
+                continue;
+            }
+            ranges.push_back( make_pair( (const char*)first.rec() , (size_t)( last - first.getOfs() + len ) ) );
+            if ( i < locs.size() ) {
+                first = locs[i];
+                last = first.getOfs();
+            }
+        }
+    }
+
+    /* a cold range scan takes a synchronous fault for every bucket and most records.
+       so when we enter a bucket, have the os start reading the records the rest of this bucket
+       points at, and the next few sibling buckets, which are where the scan goes next.
+       we don't follow the siblings' keys as that would mean faulting them in right here.
+       off by default (--btreeReadahead 0): it only pays off when the data doesn't fit in ram.
+    */
+    void BtreeCursor::readahead() {
+        _readaheadBucket = bucket;
+        int n = cmdLine.btreeReadahead;
+        if ( n <= 0 )
+            return;
+
+        vector<DiskLoc> records;
+        vector<DiskLoc> buckets;
+        const BtreeBucket *b = bucket.btree();
+
+        for ( int i = keyOfs; i >= 0 && i < b->n; i += _direction ) {
+            const DiskLoc& rl = b->k(i).recordLoc;
+            if ( !rl.isNull() )
+                records.push_back( rl );
+        }
+
+        if ( !b->parent.isNull() ) {
+            const BtreeBucket *p = b->parent.btree();
+            int pos = -1;
+            for ( int i = 0; i <= p->n; i++ ) {
+                if ( p->childForPos( i ) == bucket ) {
+                    pos = i;
+                    break;
+                }
+            }
+            if ( pos >= 0 ) {
+                for ( int i = 1; i <= n; i++ ) {
+                    int x = pos + i * _direction;
+                    if ( x < 0 || x > p->n )
+                        break;
+                    const DiskLoc& sibling = p->childForPos( x );
+                    if ( !sibling.isNull() )
+                        buckets.push_back( sibling );
+                }
+            }
+        }
+
+        vector< pair<const char*,size_t> > ranges;
+        addClusteredRanges( records , RecordReadaheadBytes , ReadaheadMaxGap , ranges );
+        addClusteredRanges( buckets , BucketSize , ReadaheadMaxGap , ranges );
+        prefetchRanges( ranges );
+    }
+
     void BtreeCursor::noteLocation() {
         if ( !eof() ) {
             BSONObj o = bucket.btree()->keyAt(keyOfs).copy();
@@ -241,6 +241,39 @@ namespace mongo {
             }
         }
     }
+
+    void ClientCursor::aboutToDelete(const vector<DiskLoc>& dls) {
+        recursive_scoped_lock lock(ccmutex);
+
+        Database *db = cc().database();
+        assert(db);
+
+        CCByLoc& bl = db->ccByLoc;
+
+        /* a cursor advanced off one record of the batch may land on another one we already 
+           handled, so go around until no cursor we're allowed to move is left on the batch. 
+           cursors move forward every pass, so this is bounded by the batch size. */
+        for ( unsigned pass = 0; pass <= dls.size(); pass++ ) {
+            bool moved = false;
+            for ( vector<DiskLoc>::const_iterator i = dls.begin(); i != dls.end(); ++i ) {
+                CCByLoc::iterator j = bl.lower_bound(ByLocKey::min(*i));
+                CCByLoc::iterator stop = bl.upper_bound(ByLocKey::max(*i));
+                bool any = false;
+                for ( ; j != stop; ++j ) {
+                    if ( ! j->second->_doingDeletes ) {
+                        any = true;
+                        break;
+                    }
+                }
+                if ( pass == 0 || any )
+                    aboutToDelete(*i);
+                moved = moved || any;
+            }
+            if ( ! moved )
+                break;
+        }
+    }
+
     void aboutToDelete(const DiskLoc& dl) { ClientCursor::aboutToDelete(dl); }
 
     ClientCursor::ClientCursor(int queryOptions, const shared_ptr<Cursor>& c, const string& ns, BSONObj query ) :
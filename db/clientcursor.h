@@ -313,6 +313,8 @@ namespace mongo {
         static unsigned numCursors() { return clientCursorsById.size(); }
         static void informAboutToDeleteBucket(const DiskLoc& b);
         static void aboutToDelete(const DiskLoc& dl);
+        /** for a batch of records that are all about to be deleted */
+        static void aboutToDelete(const vector<DiskLoc>& dls);
         static void find( const string& ns , set<CursorId>& all );
 
 
@@ -49,6 +49,16 @@ namespace mongo {
         void setConnection( DBClientWithCommands *c ) { conn.reset( c ); }
         bool go(const char *masterHost, string& errmsg, const string& fromdb, bool logForRepl, bool slaveOk, bool useReplAuth, bool snapshot);
 
+        /* the pieces of go(), for cloneDatabases() */
+
+        /* the system.namespaces entries of fromdb's collections that should be cloned.  no lock needed. */
+        bool listCollections( const string& fromdb , bool slaveOk , list<BSONObj>& toClone , string& errmsg );
+        /* copies one collection from listCollections() into todb, building only its _id index.
+           @return number of objects in the copy */
+        long long cloneCollection( const BSONObj& collection , const string& todb , bool logForRepl , bool masterSameProcess , bool slaveOk , bool snapshot );
+        /* builds the other indexes of fromdb in todb, in bulk as the collections already have their data */
+        void copyIndexes( const string& fromdb , const string& todb , bool logForRepl , bool masterSameProcess , bool slaveOk );
+
         bool copyCollection( const string& from , const string& ns , const BSONObj& query , string& errmsg , bool copyIndexes = true, bool logForRepl = true );
     };
 
@@ -261,112 +271,126 @@ namespace mongo {
         /* todo: we can put these releases inside dbclient or a dbclient specialization.
            or just wait until we get rid of global lock anyway.
            */
-        string ns = fromdb + ".system.namespaces";
         list<BSONObj> toClone;
         {  
             dbtemprelease r;
 		
             // just using exhaust for collection copying right now
-            auto_ptr<DBClientCursor> c;
-            {
-                if ( conn.get() ) {
-                    // nothing to do
-                } else if ( !masterSameProcess ) {
-                    ConnectionString cs = ConnectionString::parse( masterHost, errmsg );
-                    auto_ptr<DBClientBase> con( cs.connect( errmsg ));
-                    if ( !con.get() )
-                        return false;
-                    if( !replAuthenticate(con.get()) )
-                        return false;
-                    
-                    conn = con;
-                } else {
-                    conn.reset( new DBDirectClient() );
-                }
-                c = conn->query( ns.c_str(), BSONObj(), 0, 0, 0, slaveOk ? QueryOption_SlaveOk : 0 );
+            if ( conn.get() ) {
+                // nothing to do
+            } else if ( !masterSameProcess ) {
+                ConnectionString cs = ConnectionString::parse( masterHost, errmsg );
+                auto_ptr<DBClientBase> con( cs.connect( errmsg ));
+                if ( !con.get() )
+                    return false;
+                if( !replAuthenticate(con.get()) )
+                    return false;
+                
+                conn = con;
+            } else {
+                conn.reset( new DBDirectClient() );
             }
 
-            if ( c.get() == 0 ) {
-                errmsg = "query failed " + ns;
+            if ( ! listCollections( fromdb , slaveOk , toClone , errmsg ) )
                 return false;
-            }
-            
-            while ( c->more() ){
-                BSONObj collection = c->next();
-
-                log(2) << "\t cloner got " << collection << endl;
-
-                BSONElement e = collection.getField("name");
-                if ( e.eoo() ) {
-                    string s = "bad system.namespaces object " + collection.toString();
-                    massert( 10290 , s.c_str(), false);
-                }
-                assert( !e.eoo() );
-                assert( e.type() == String );
-                const char *from_name = e.valuestr();
-
-                if( strstr(from_name, ".system.") ) { 
-                    /* system.users and s.js is cloned -- but nothing else from system.
-                     * system.indexes is handled specially at the end*/
-                    if( legalClientSystemNS( from_name , true ) == 0 ){
-                        log(2) << "\t\t not cloning because system collection" << endl;
-                        continue;
-                    }
-                }
-                if( ! isANormalNSName( from_name ) ){
-                    log(2) << "\t\t not cloning because has $ " << endl;
-                    continue;
-                }            
-                toClone.push_back( collection.getOwned() );
-            }
         }
 
         for ( list<BSONObj>::iterator i=toClone.begin(); i != toClone.end(); i++ ){
             {
                 dbtemprelease r;
             }
-            BSONObj collection = *i;
-            log(2) << "  really will clone: " << collection << endl;
-            const char * from_name = collection["name"].valuestr();
-            BSONObj options = collection.getObjectField("options");
-            
-            /* change name "<fromdb>.collection" -> <todb>.collection */
-            const char *p = strchr(from_name, '.');
-            assert(p);
-            string to_name = todb + p;
+            cloneCollection( *i , todb , logForRepl , masterSameProcess , slaveOk , snapshot );
+        }
 
-            bool wantIdIndex = false;
-            {
-                string err;
-                const char *toname = to_name.c_str();
-                /* we defer building id index for performance - building it in batch is much faster */ 
-                userCreateNS(toname, options, err, logForRepl, &wantIdIndex);
-            }
-            log(1) << "\t\t cloning " << from_name << " -> " << to_name << endl;
-            Query q;
-            if( snapshot ) 
-                q.snapshot();
-            copy(from_name, to_name.c_str(), false, logForRepl, masterSameProcess, slaveOk, q);
-
-            if( wantIdIndex ) {
-                /* we need dropDups to be true as we didn't do a true snapshot and this is before applying oplog operations 
-                   that occur during the initial sync.  inDBRepair makes dropDups be true.
-                   */
-                bool old = inDBRepair;
-                try {
-                    inDBRepair = true;
-                    ensureIdIndexForNewNs(to_name.c_str());
-                    inDBRepair = old;
-                }
-                catch(...) { 
-                    inDBRepair = old;
-                    throw;
+        // now build the indexes
+        copyIndexes( fromdb , todb , logForRepl , masterSameProcess , slaveOk );
+
+        return true;
+    }
+
+    bool Cloner::listCollections( const string& fromdb , bool slaveOk , list<BSONObj>& toClone , string& errmsg ) {
+        string ns = fromdb + ".system.namespaces";
+        auto_ptr<DBClientCursor> c = conn->query( ns.c_str(), BSONObj(), 0, 0, 0, slaveOk ? QueryOption_SlaveOk : 0 );
+        if ( c.get() == 0 ) {
+            errmsg = "query failed " + ns;
+            return false;
+        }
+        
+        while ( c->more() ){
+            BSONObj collection = c->next();
+
+            log(2) << "\t cloner got " << collection << endl;
+
+            BSONElement e = collection.getField("name");
+            if ( e.eoo() ) {
+                string s = "bad system.namespaces object " + collection.toString();
+                massert( 10290 , s.c_str(), false);
+            }
+            assert( !e.eoo() );
+            assert( e.type() == String );
+            const char *from_name = e.valuestr();
+
+            if( strstr(from_name, ".system.") ) { 
+                /* system.users and s.js is cloned -- but nothing else from system.
+                 * system.indexes is handled specially at the end*/
+                if( legalClientSystemNS( from_name , true ) == 0 ){
+                    log(2) << "\t\t not cloning because system collection" << endl;
+                    continue;
                 }
             }
+            if( ! isANormalNSName( from_name ) ){
+                log(2) << "\t\t not cloning because has $ " << endl;
+                continue;
+            }            
+            toClone.push_back( collection.getOwned() );
         }
+        return true;
+    }
 
-        // now build the indexes
+    long long Cloner::cloneCollection( const BSONObj& collection , const string& todb , bool logForRepl , bool masterSameProcess , bool slaveOk , bool snapshot ) {
+        log(2) << "  really will clone: " << collection << endl;
+        const char * from_name = collection["name"].valuestr();
+        BSONObj options = collection.getObjectField("options");
+        
+        /* change name "<fromdb>.collection" -> <todb>.collection */
+        const char *p = strchr(from_name, '.');
+        assert(p);
+        string to_name = todb + p;
 
+        bool wantIdIndex = false;
+        {
+            string err;
+            const char *toname = to_name.c_str();
+            /* we defer building id index for performance - building it in batch is much faster */ 
+            userCreateNS(toname, options, err, logForRepl, &wantIdIndex);
+        }
+        log(1) << "\t\t cloning " << from_name << " -> " << to_name << endl;
+        Query q;
+        if( snapshot ) 
+            q.snapshot();
+        copy(from_name, to_name.c_str(), false, logForRepl, masterSameProcess, slaveOk, q);
+
+        if( wantIdIndex ) {
+            /* we need dropDups to be true as we didn't do a true snapshot and this is before applying oplog operations 
+               that occur during the initial sync.  inDBRepair makes dropDups be true.
+               */
+            bool old = inDBRepair;
+            try {
+                inDBRepair = true;
+                ensureIdIndexForNewNs(to_name.c_str());
+                inDBRepair = old;
+            }
+            catch(...) { 
+                inDBRepair = old;
+                throw;
+            }
+        }
+
+        NamespaceDetails *d = nsdetails( to_name.c_str() );
+        return d ? d->stats.nrecords : 0;
+    }
+
+    void Cloner::copyIndexes( const string& fromdb , const string& todb , bool logForRepl , bool masterSameProcess , bool slaveOk ) {
         string system_indexes_from = fromdb + ".system.indexes";
         string system_indexes_to = todb + ".system.indexes";
         /* [dm]: is the ID index sometimes not called "_id_"?  There is other code in the system that looks for a "_id" prefix 
@@ -374,10 +398,149 @@ namespace mongo {
                  is dubious here at the moment.
         */
         copy(system_indexes_from.c_str(), system_indexes_to.c_str(), true, logForRepl, masterSameProcess, slaveOk, BSON( "name" << NE << "_id_" ) );
+    }
+
+    /* work for cloneDatabases(), shared by its threads */
+    class CloneJob : boost::noncopyable {
+    public:
+        CloneJob( const string& host , boost::function<void(const string&)> progress ) 
+            : _m( "CloneJob" ) , _host( host ) , _progress( progress ) , _total( 0 ) , _done( 0 ) { 
+        }
+
+        void add( const string& db , const BSONObj& collection ) {
+            _todo.push_back( make_pair( db , collection ) );
+            _total++;
+        }
+        int total() const { return _total; }
 
+        /* @return false when there is nothing left, or another thread failed */
+        bool next( pair<string,BSONObj>& c ) {
+            scoped_lock lk( _m );
+            if ( _todo.empty() || ! _errmsg.empty() )
+                return false;
+            c = _todo.front();
+            _todo.pop_front();
+            return true;
+        }
+
+        void done( const string& ns , long long n , int millis ) {
+            int done;
+            {
+                scoped_lock lk( _m );
+                done = ++_done;
+            }
+            string msg = str::stream() << "initial sync cloned " << ns << ": " << n << " objects in " << millis << "ms, " 
+                                       << done << " of " << _total << " collections";
+            log() << msg << endl;
+            if ( _progress )
+                _progress( msg );
+        }
+
+        void fail( const string& errmsg ) {
+            scoped_lock lk( _m );
+            if ( _errmsg.empty() )
+                _errmsg = errmsg;
+        }
+        string errmsg() {
+            scoped_lock lk( _m );
+            return _errmsg;
+        }
+
+        /* one thread with its own connection to the source */
+        void work() {
+            Client::initThread( "initial sync cloner" );
+            try {
+                string errmsg;
+                ConnectionString cs = ConnectionString::parse( _host , errmsg );
+                auto_ptr<DBClientBase> con( cs.connect( errmsg ) );
+                if ( ! con.get() || ! replAuthenticate( con.get() ) ) {
+                    fail( "couldn't connect to " + _host + " " + errmsg );
+                }
+                else {
+                    Cloner c;
+                    c.setConnection( con.release() );
+                    pair<string,BSONObj> coll;
+                    while ( next( coll ) ) {
+                        Timer t;
+                        long long n;
+                        {
+                            writelock lk( coll.first );
+                            Client::Context ctx( coll.first );
+                            n = c.cloneCollection( coll.second , coll.first , /*logForRepl*/false , /*masterSameProcess*/false , /*slaveOk*/true , /*snapshot*/false );
+                        }
+                        done( coll.second["name"].String() , n , t.millis() );
+                    }
+                }
+            }
+            catch ( std::exception& e ) {
+                fail( e.what() );
+            }
+            cc().shutdown();
+        }
+
+    private:
+        mongo::mutex _m;
+        string _host;
+        boost::function<void(const string&)> _progress;
+        list< pair<string,BSONObj> > _todo;
+        int _total;
+        int _done;
+        string _errmsg;
+    };
+
+    /* copies dbs from host for an initial sync.  the collections are spread over nConnections threads, each with its 
+       own connection, so one thread's network transfer overlaps another's inserts.  each collection gets its _id index 
+       as soon as it has been copied; the other indexes are built at the end, per db.
+       call with no lock held.
+       progress - called after each collection with a status line, e.g. for the heartbeat message
+    */
+    bool cloneDatabases( const string& host , const list<string>& dbs , int nConnections , 
+                         boost::function<void(const string&)> progress , string& errmsg ) {
+        CloneJob job( host , progress );
+
+        Cloner lister;
+        {
+            ConnectionString cs = ConnectionString::parse( host , errmsg );
+            auto_ptr<DBClientBase> con( cs.connect( errmsg ) );
+            if ( ! con.get() || ! replAuthenticate( con.get() ) ) {
+                errmsg = "couldn't connect to " + host + " " + errmsg;
+                return false;
+            }
+            lister.setConnection( con.release() );
+        }
+        for ( list<string>::const_iterator i = dbs.begin(); i != dbs.end(); i++ ) {
+            list<BSONObj> toClone;
+            if ( ! lister.listCollections( *i , /*slaveOk*/true , toClone , errmsg ) )
+                return false;
+            for ( list<BSONObj>::iterator j = toClone.begin(); j != toClone.end(); j++ )
+                job.add( *i , *j );
+        }
+        log() << "initial sync cloning " << job.total() << " collections from " << host << " over " 
+              << min( nConnections , job.total() ) << " connections" << endl;
+
+        {
+            vector< shared_ptr<boost::thread> > threads;
+            for ( int i = 0; i < nConnections && i < job.total(); i++ )
+                threads.push_back( shared_ptr<boost::thread>( new boost::thread( boost::bind( &CloneJob::work , &job ) ) ) );
+            for ( unsigned i = 0; i < threads.size(); i++ )
+                threads[i]->join();
+        }
+        errmsg = job.errmsg();
+        if ( ! errmsg.empty() )
+            return false;
+
+        for ( list<string>::const_iterator i = dbs.begin(); i != dbs.end(); i++ ) {
+            string msg = "initial sync building indexes for " + *i;
+            log() << msg << endl;
+            if ( progress )
+                progress( msg );
+            writelock lk( *i );
+            Client::Context ctx( *i );
+            lister.copyIndexes( *i , *i , /*logForRepl*/false , /*masterSameProcess*/false , /*slaveOk*/true );
+        }
         return true;
     }
-    
+
     /* slaveOk     - if true it is ok if the source of the data is !ismaster.
        useReplAuth - use the credentials we normally use as a replication slave for the cloning
        snapshot    - use $snapshot mode for copying collections.  note this should not be used when it isn't required, as it will be slower.
@@ -404,6 +567,7 @@ namespace mongo {
             help << "{ clone : \"host13\" }";
         }
         CmdClone() : Command("clone") { }
+        virtual bool longRunning() const { return true; }
         virtual bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
             string from = cmdObj.getStringField("clone");
             if ( from.empty() )
@@ -423,6 +587,7 @@ namespace mongo {
         }
         virtual LockType locktype() const { return NONE; }
         CmdCloneCollection() : Command("cloneCollection") { }
+        virtual bool longRunning() const { return true; }
         virtual void help( stringstream &help ) const {
             help << "{ cloneCollection: <namespace>, from: <host> [,query: <query_filter>] [,copyIndexes:<bool>] }"
                 "\nCopies a collection from one server to another. Do not use on a single server as the destination "
@@ -512,6 +677,7 @@ namespace mongo {
     class CmdCopyDb : public Command {
     public:
         CmdCopyDb() : Command("copydb") { }
+        virtual bool longRunning() const { return true; }
         virtual bool adminOnly() const {
             return true;
         }
@@ -46,6 +46,7 @@ namespace mongo {
             ("logpath", po::value<string>() , "log file to send write to instead of stdout - has to be a file, not directory" )
             ("logappend" , "append to logpath instead of over-writing" )
             ("pidfilepath", po::value<string>(), "full path to pidfile (if not set, no pidfile is created)")
+            ("networkCompression", "compress traffic on connections to other servers that support it")
 #ifndef _WIN32
             ("fork" , "fork server process" )
 #endif
@@ -143,6 +144,10 @@ namespace mongo {
             cmdLine.quiet = true;
         }
 
+        if (params.count("networkCompression")) {
+            cmdLine.networkCompression = true;
+        }
+
         string logpath;
 
 #ifndef _WIN32
@@ -89,6 +89,11 @@ namespace mongo {
         */
         virtual bool logTheOp() { return false; }
 
+        /* Return true if the command can run for a long time (map/reduce, copying a database...).
+           Such commands take their admission ticket from a separate pool, see admission.h.
+        */
+        virtual bool longRunning() const { return false; }
+
         virtual void help( stringstream& help ) const;
 
         /* Return true if authentication and security applies to the commands.  Some commands 
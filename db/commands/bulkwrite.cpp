@@ -0,0 +1,151 @@
+// bulkwrite.cpp
+
+/**
+*    Copyright (C) 2008 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pch.h"
+#include "../commands.h"
+#include "../instance.h"
+#include "../query.h"
+#include "../repl.h"
+#include "../replpair.h"
+#include "../stats/counters.h"
+#include "../../s/d_logic.h"
+
+namespace mongo {
+
+    /**
+     * { bulkWrite : <collection> , ops : [ <op> ... ] , ordered : <bool> }
+     *
+     * op is one of
+     *   { op : "insert" , doc : <object> }
+     *   { op : "update" , q : <query> , u : <update> , upsert : <bool> , multi : <bool> }
+     *   { op : "remove" , q : <query> , justOne : <bool> }
+     *
+     * All ops run under one write lock and the reply has a result per op, so a batch of safe
+     * writes takes one round trip instead of two per op.  ordered (the default) stops at the
+     * first op that fails, otherwise the rest still run.
+     */
+    class BulkWriteCommand : public Command {
+    public:
+        BulkWriteCommand() : Command( "bulkWrite" ) {}
+        virtual bool slaveOk() const { return false; }
+        virtual LockType locktype() const { return WRITE; }
+        virtual bool logTheOp() { return false; } // each op is logged by itself
+        virtual void help( stringstream &help ) const {
+            help << "insert, update and remove in one batch\n"
+                 << "{ bulkWrite : 'collection' , ops : [ { op : 'insert' , doc : {...} } , "
+                 << "{ op : 'update' , q : {...} , u : {...} , upsert : false , multi : false } , "
+                 << "{ op : 'remove' , q : {...} , justOne : false } ] , ordered : true }";
+        }
+
+        bool run(const string& dbname, BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl ){
+            string coll = cmdObj.firstElement().valuestrsafe();
+            if ( coll.empty() ) {
+                errmsg = "no collection name";
+                return false;
+            }
+            string ns = dbname + '.' + coll;
+
+            if ( cmdObj["ops"].type() != Array ) {
+                errmsg = "ops has to be an array";
+                return false;
+            }
+            bool ordered = cmdObj["ordered"].eoo() || cmdObj["ordered"].trueValue();
+
+            if ( ! isMasterNs( ns.c_str() ) ) {
+                errmsg = "not master";
+                return false;
+            }
+            if ( haveLocalShardingInfo( ns ) ) {
+                errmsg = "bulkWrite doesn't support sharded collections yet";
+                return false;
+            }
+
+            OpDebug& debug = cc().curop()->debug();
+            BSONArrayBuilder results( result.subarrayStart( "results" ) );
+            int applied = 0;
+            int errors = 0;
+
+            BSONObjIterator i( cmdObj["ops"].embeddedObject() );
+            while ( i.more() ) {
+                BSONElement e = i.next();
+                BSONObjBuilder r( results.subobjStart() );
+                try {
+                    uassert( 13539 , "op has to be an object" , e.type() == Object );
+                    apply( ns.c_str() , e.embeddedObject() , debug , r );
+                    applied++;
+                }
+                catch ( DBException& ex ) {
+                    r.append( "err" , ex.what() );
+                    r.append( "code" , ex.getCode() );
+                    errors++;
+                }
+                r.done();
+                if ( errors && ordered )
+                    break;
+            }
+            results.done();
+
+            result.append( "nApplied" , applied );
+            result.append( "nErrors" , errors );
+            return true;
+        }
+
+    private:
+        void apply( const char *ns , const BSONObj& op , OpDebug& debug , BSONObjBuilder& r ) {
+            string type = op["op"].valuestrsafe();
+
+            if ( type == "insert" ) {
+                uassert( 13540 , "insert needs a doc" , op["doc"].type() == Object );
+                BSONObj js = op["doc"].embeddedObject();
+                uassert( 13551 , "object to insert too large", js.objsize() <= BSONObjMaxUserSize );
+                BSONObjIterator i( js );
+                while ( i.more() )
+                    uassert( 13552 , "object to insert can't have $ modifiers" , i.next().fieldName()[0] != '$' );
+
+                theDataFileMgr.insertWithObjMod( ns , js , false );
+                logOp( "i" , ns , js );
+                globalOpCounters.gotInsert();
+                r.append( "n" , 1 );
+            }
+            else if ( type == "update" ) {
+                uassert( 13541 , "update needs q and u" , op["q"].type() == Object && op["u"].type() == Object );
+                BSONObj toupdate = op["u"].embeddedObject();
+                uassert( 13553 , "update object too large", toupdate.objsize() <= BSONObjMaxUserSize );
+
+                UpdateResult res = updateObjects( ns , toupdate , op["q"].embeddedObject() ,
+                                                  op["upsert"].trueValue() , op["multi"].trueValue() , true , debug );
+                globalOpCounters.gotUpdate();
+                r.appendNumber( "n" , (long long) res.num );
+                r.appendBool( "updatedExisting" , res.existing );
+                if ( res.upserted.isSet() )
+                    r.append( "upserted" , res.upserted );
+            }
+            else if ( type == "remove" ) {
+                uassert( 13542 , "remove needs q" , op["q"].type() == Object );
+                long long n = deleteObjects( ns , op["q"].embeddedObject() , op["justOne"].trueValue() , true );
+                globalOpCounters.gotDelete();
+                r.appendNumber( "n" , n );
+            }
+            else {
+                uasserted( 13543 , str::stream() << "unknown bulkWrite op: " << type );
+            }
+        }
+
+    } bulkWriteCommand;
+
+}
@@ -25,6 +25,7 @@ namespace mongo {
     class GroupCommand : public Command {
     public:
         GroupCommand() : Command("group"){}
+        virtual bool longRunning() const { return true; }
         virtual LockType locktype() const { return READ; } 
         virtual bool slaveOk() const { return true; }
         virtual bool slaveOverrideOk() { return true; }
@@ -410,6 +410,7 @@ namespace mongo {
         class MapReduceCommand : public Command {
         public:
             MapReduceCommand() : Command("mapReduce", false, "mapreduce"){}
+            virtual bool longRunning() const { return true; }
             virtual bool slaveOk() const { return true; }
         
             virtual void help( stringstream &help ) const {
@@ -40,6 +40,7 @@
 #include "restapi.h"
 #include "dbwebserver.h"
 #include "dur.h"
+#include "admission.h"
 
 #if defined(_WIN32)
 # include "../util/ntservice.h"
@@ -702,6 +703,10 @@ int main(int argc, char* argv[], char *envp[] )
         ("profile",po::value<int>(), "0=off 1=slow, 2=all")
         ("slowms",po::value<int>(&cmdLine.slowMS)->default_value(100), "value of slow for profile and console log" )
         ("maxConns",po::value<int>(), "max number of simultaneous connections")
+        ("admissionReads",po::value<int>(), "max number of queries and getmores running at once (0=unlimited)")
+        ("admissionWrites",po::value<int>(), "max number of inserts, updates and removes running at once (0=unlimited)")
+        ("admissionCommands",po::value<int>(), "max number of commands running at once (0=unlimited)")
+        ("admissionLongRunning",po::value<int>(), "max number of long running commands (mapReduce, group, eval, copydb...) running at once (0=unlimited)")
 		#if !defined(_WIN32)
         ("nounixsocket", "disable listening on unix sockets")
 		#endif
@@ -741,6 +746,7 @@ int main(int argc, char* argv[], char *envp[] )
 
     hidden_options.add_options()
         ("pretouch", po::value<int>(), "n pretouch threads for applying replicationed operations")
+        ("btreeReadahead", po::value<int>(&cmdLine.btreeReadahead)->default_value(0), "number of sibling btree buckets to prefetch during index scans (default 0=off)")
         ("command", po::value< vector<string> >(), "command")
         ("cacheSize", po::value<long>(), "cache size (in MB) for rec store")
         ;
@@ -1020,6 +1026,19 @@ int main(int argc, char* argv[], char *envp[] )
             }
             connTicketHolder.resize( newSize );
         }
+        {
+            const char *opts[] = { "admissionReads" , "admissionWrites" , "admissionCommands" , "admissionLongRunning" };
+            for ( int i = 0; i < Admission::NumClasses; i++ ) {
+                if ( params.count( opts[i] ) == 0 )
+                    continue;
+                int n = params[ opts[i] ].as<int>();
+                if ( n < 0 ) {
+                    out() << opts[i] << " can't be negative" << endl;
+                    dbexit( EXIT_BADOPTIONS );
+                }
+                admission.setLimit( (Admission::OpClass) i , n );
+            }
+        }
         if (params.count("nounixsocket")){
             noUnixSocket = true;
         }
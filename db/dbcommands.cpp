@@ -38,6 +38,7 @@
 #include "queryoptimizer.h"
 #include "../scripting/engine.h"
 #include "stats/counters.h"
+#include "admission.h"
 #include "background.h"
 #include "../util/version.h"
 #include "../s/d_writeback.h"
@@ -142,8 +143,13 @@ namespace mongo {
 
                 long long passes = 0;
                 char buf[32];
+                OpTime op = c.getLastOp(); // the last of all the writes on this connection so far
                 while ( 1 ){
-                    if ( opReplicatedEnough( c.getLastOp() , w ) )
+                    // wakes up when the slaves get there, and now and then to check for a timeout or kill
+                    int wait = 100;
+                    if ( timeout > 0 )
+                        wait = max( 0 , min( wait , timeout - (int) t.millis() ) );
+                    if ( waitForReplication( op , w , wait ) )
                         break;
                     
                     if ( timeout > 0 && t.millis() >= timeout ){
@@ -156,7 +162,6 @@ namespace mongo {
 
                     assert( sprintf( buf , "w block pass: %lld" , ++passes ) < 30 );
                     c.curop()->setMessage( buf );
-                    sleepmillis(1);
                     killCurrentOp.checkForInterrupt();
                 }
                 result.appendNumber( "wtime" , t.millis() );
@@ -230,6 +235,7 @@ namespace mongo {
         }
         virtual LockType locktype() const { return WRITE; } 
         CmdRepairDatabase() : Command("repairDatabase") {}
+        virtual bool longRunning() const { return true; }
         bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
             BSONElement e = cmdObj.firstElement();
             log() << "repairDatabase " << dbname << endl;
@@ -415,6 +421,18 @@ namespace mongo {
                 bb.done();
             }
 
+            {
+                BSONObjBuilder bb( result.subobjStart( "messageBuffers" ) );
+                bufferPool.appendStats( bb );
+                bb.done();
+            }
+
+            {
+                BSONObjBuilder bb( result.subobjStart( "admission" ) );
+                admission.appendStats( bb );
+                bb.done();
+            }
+
             
             timeBuilder.appendNumber( "after counters" , Listener::getElapsedTimeMillis() - start );            
 
@@ -760,6 +778,7 @@ namespace mongo {
             help << "re-index a collection";
         }
         CmdReIndex() : Command("reIndex") { }
+        virtual bool longRunning() const { return true; }
         bool run(const string& dbname , BSONObj& jsobj, string& errmsg, BSONObjBuilder& result, bool /*fromRepl*/) {
             static DBDirectClient db;
 
@@ -1211,6 +1230,7 @@ namespace mongo {
     class CmdCloneCollectionAsCapped : public Command {
     public:
         CmdCloneCollectionAsCapped() : Command( "cloneCollectionAsCapped" ) {}
+        virtual bool longRunning() const { return true; }
         virtual bool slaveOk() const { return false; }
         virtual LockType locktype() const { return WRITE; } 
         virtual void help( stringstream &help ) const {
@@ -1272,6 +1292,7 @@ namespace mongo {
     class CmdConvertToCapped : public Command {
     public:
         CmdConvertToCapped() : Command( "convertToCapped" ) {}
+        virtual bool longRunning() const { return true; }
         virtual bool slaveOk() const { return false; }
         virtual LockType locktype() const { return WRITE; } 
         virtual void help( stringstream &help ) const {
@@ -1475,6 +1496,7 @@ namespace mongo {
     class DBHashCmd : public Command {
     public:
         DBHashCmd() : Command( "dbHash", false, "dbhash" ){}
+        virtual bool longRunning() const { return true; }
         virtual bool slaveOk() const { return true; }
         virtual LockType locktype() const { return READ; }
         virtual bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool){
@@ -1590,18 +1612,6 @@ namespace mongo {
         }
     } cmdSleep;
 
-    class AvailableQueryOptions : public Command {
-    public:
-        AvailableQueryOptions() : Command( "availablequeryoptions" ){}
-        virtual bool slaveOk() const { return true; }
-        virtual LockType locktype() const { return NONE; }
-        virtual bool requiresAuth() { return false; }
-        virtual bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool){
-            result << "options" << QueryOption_AllSupported;
-            return true;
-        }
-    } availableQueryOptionsCmd;    
-    
     // just for testing
     class CapTrunc : public Command {
     public:
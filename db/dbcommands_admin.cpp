@@ -69,6 +69,7 @@ namespace mongo {
     class ValidateCmd : public Command {
     public:
         ValidateCmd() : Command( "validate" ){}
+        virtual bool longRunning() const { return true; }
 
         virtual bool slaveOk() const {
             return true;
@@ -77,14 +77,21 @@ namespace mongo {
             help << "{ get:1, notablescan:1 }\n";
             help << "supported so far:\n";
             help << "  notablescan\n";
+            help << "  btreeReadahead\n";
             help << "{ get:'*' } to get everything\n";
         }
         bool run(const string& dbname, BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl ) {
             bool all = cmdObj.firstElement().valuestrsafe();
+            int n = 0;
             if( all || cmdObj.hasElement("notablescan") ) {
                 result.append("notablescan", cmdLine.noTableScan);
+                n++;
             }
-            else {
+            if( all || cmdObj.hasElement("btreeReadahead") ) {
+                result.append("btreeReadahead", cmdLine.btreeReadahead);
+                n++;
+            }
+            if ( n == 0 ) {
                 errmsg = "no option found to get";
                 return false;
             }
@@ -103,12 +110,17 @@ namespace mongo {
             help << "{ set:1, notablescan:true }\n";
             help << "supported so far:\n";
             help << "  notablescan\n";
+            help << "  btreeReadahead\n";
         }
         bool run(const string& dbname, BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl ){
             if( cmdObj.hasElement("notablescan") ) {
                 result.append("was", cmdLine.noTableScan);
                 cmdLine.noTableScan = cmdObj["notablescan"].Bool();
             }
+            else if( cmdObj["btreeReadahead"].isNumber() ) {
+                result.append("was", cmdLine.btreeReadahead);
+                cmdLine.btreeReadahead = cmdObj["btreeReadahead"].numberInt();
+            }
             else {
                 errmsg = "no option found to set";
                 return false;
@@ -117,6 +129,22 @@ namespace mongo {
         }
     } cmdSet;
 
+    class AvailableQueryOptions : public Command {
+    public:
+        AvailableQueryOptions() : Command( "availablequeryoptions" ){}
+        virtual bool slaveOk() const { return true; }
+        virtual LockType locktype() const { return NONE; }
+        virtual bool requiresAuth() { return false; }
+        virtual void help( stringstream& help ) const {
+            help << "the query options this server supports.  note that through mongos an exhaust query keeps\n"
+                    "a mongos thread and its shard connections busy until the whole result has been sent";
+        }
+        virtual bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool){
+            result << "options" << QueryOption_AllSupported;
+            return true;
+        }
+    } availableQueryOptionsCmd;
+    
     class PingCommand : public Command {
     public:
         PingCommand() : Command( "ping" ){}
@@ -121,6 +121,7 @@ namespace mongo {
         }
         virtual LockType locktype() const { return NONE; }
         CmdEval() : Command("eval", false, "$eval") { }
+        virtual bool longRunning() const { return true; }
         bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
             
             AuthenticationInfo *ai = cc().getAuthenticationInfo();
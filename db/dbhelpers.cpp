@@ -289,23 +289,33 @@ namespace mongo {
         scoped_ptr<ClientCursor> cc( new ClientCursor( QueryOption_NoCursorTimeout , c , ns ) );
         cc->setDoingDeletes( true );
         
+        vector<DiskLoc> batch;
         while ( c->ok() ){
-            DiskLoc rloc = c->currLoc();
-            BSONObj key = c->currKey();
-
-            if ( callback )
-                callback->goingToDelete( c->current() );
-            
-            c->advance();
+            // gather a batch, stepping the cursor past it so it isn't disturbed by the deletes
+            batch.clear();
+            int batchBytes = 0;
+            while ( c->ok() && batch.size() < RemoveRangeBatchSize && batchBytes < RemoveRangeBatchBytes ){
+                DiskLoc rloc = c->currLoc();
+                BSONObj o = c->current();
+
+                if ( callback )
+                    callback->goingToDelete( o );
+
+                batch.push_back( rloc );
+                batchBytes += o.objsize();
+                c->advance();
+            }
             c->noteLocation();
-            
-            logOp( "d" , ns.c_str() , rloc.obj()["_id"].wrap() );
-            theDataFileMgr.deleteRecord(ns.c_str() , rloc.rec(), rloc);
-            num++;
+
+            for ( unsigned j=0; j<batch.size(); j++ )
+                logOp( "d" , ns.c_str() , batch[j].obj()["_id"].wrap() );
+            theDataFileMgr.deleteRecords( ns.c_str() , batch );
+            num += batch.size();
 
             c->checkLocation();
 
-            if ( yield && ! cc->yieldSometimes() ){
+            // give up the lock between batches, so the time we hold it is bounded by one batch
+            if ( yield && ! cc->yield() ){
                 // cursor got finished by someone else, so we're done
                 break;
             }
@@ -120,12 +120,17 @@ namespace mongo {
         // TODO: this should be somewhere else probably
         static BSONObj toKeyFormat( const BSONObj& o , BSONObj& key );
 
+        static const unsigned RemoveRangeBatchSize = 256;
+        static const int RemoveRangeBatchBytes = 4 * 1024 * 1024;
+
         class RemoveCallback {
         public:
             virtual ~RemoveCallback(){}
             virtual void goingToDelete( const BSONObj& o ) = 0;
         };
-        /* removeRange: operation is oplog'd */
+        /* removeRange: operation is oplog'd
+           documents are deleted in batches of up to RemoveRangeBatchSize, if yield is set the lock is released after each batch
+        */
         static long long removeRange( const string& ns , const BSONObj& min , const BSONObj& max , bool yield = false , bool maxInclusive = false , RemoveCallback * callback = 0 );
 
         /* Remove all objects from a collection.
@@ -0,0 +1,479 @@
+// db/fts/fts.cpp
+
+/**
+ *    Copyright (C) 2008 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+#include "../namespace-inl.h"
+#include "../jsobj.h"
+#include "../index.h"
+#include "../../util/unittest.h"
+#include "../commands.h"
+#include "../pdfile.h"
+#include "../btree.h"
+#include "../curop-inl.h"
+#include "../matcher.h"
+
+//#define FTSDEBUG(x) cout << x << endl
+#define FTSDEBUG(x)
+
+/**
+ * full text search index
+ *   { description : "text" }
+ *   { title : "text" , description : "text" } , with optional { weights : { title : 5 } } in the index info
+ *
+ * every string in the indexed fields is split into words, stop words are dropped and the rest
+ * is stemmed.  one key { "" : term , "" : weight } is stored per distinct term of a document,
+ * so looking up a term is a btree range scan and the weight is available without loading the record.
+ *
+ * queries:   db.foo.find( { description : { $text : "red shoes" } } )
+ * command:   db.runCommand( { textSearch : "foo" , search : "red shoes" , limit : 20 } )
+ * results come back in score order
+ */
+namespace mongo {
+
+    string FTSNAME = "text";
+
+    /** a document and how well it matched */
+    struct FTSScore {
+        FTSScore() : _score( 0 ){}
+        FTSScore( const DiskLoc& loc , double score ) : _loc( loc ) , _score( score ){}
+
+        bool operator<( const FTSScore& other ) const {
+            if ( _score != other._score )
+                return _score > other._score;
+            return _loc < other._loc;
+        }
+
+        DiskLoc _loc;
+        double _score;
+    };
+
+    typedef vector<FTSScore> FTSResults;
+
+    class FTSIndex : public IndexType {
+    public:
+
+        FTSIndex( const IndexPlugin* plugin , const IndexSpec* spec )
+            : IndexType( plugin , spec ){
+
+            BSONObj weights;
+            if ( spec->info["weights"].type() == Object )
+                weights = spec->info["weights"].embeddedObject();
+
+            BSONObjIterator i( spec->keyPattern );
+            while ( i.more() ){
+                BSONElement e = i.next();
+                uassert( 13531 , "all fields of a text index have to be \"text\"" ,
+                         e.type() == String && FTSNAME == e.valuestr() );
+                _fields.push_back( e.fieldName() );
+
+                double w = 1;
+                BSONElement we = weights[e.fieldName()];
+                if ( we.isNumber() ){
+                    w = we.numberDouble();
+                    uassert( 13532 , "text index weights have to be positive" , w > 0 );
+                }
+                _weights.push_back( w );
+            }
+        }
+
+        // ---- tokenizing ----
+
+        static bool isWordChar( unsigned char c ){
+            // bytes >= 0x80 are utf8 sequences, keep them as part of the word
+            return isalnum( c ) || c >= 0x80;
+        }
+
+        static bool isStopWord( const string& w ){
+            static const char * stopWords[] = {
+                "a" , "an" , "and" , "are" , "as" , "at" , "be" , "but" , "by" , "for" , "from" ,
+                "has" , "have" , "he" , "her" , "his" , "i" , "if" , "in" , "into" , "is" , "it" ,
+                "its" , "of" , "on" , "or" , "our" , "she" , "so" , "than" , "that" , "the" , "their" ,
+                "them" , "then" , "there" , "these" , "they" , "this" , "to" , "was" , "we" , "were" ,
+                "what" , "when" , "which" , "who" , "will" , "with" , "you" , "your" , 0
+            };
+            for ( int i=0; stopWords[i]; i++ )
+                if ( w == stopWords[i] )
+                    return true;
+            return false;
+        }
+
+        static bool isVowel( char c ){
+            return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+        }
+
+        static bool hasVowel( const string& s , size_t len ){
+            for ( size_t i=0; i<len && i<s.size(); i++ )
+                if ( isVowel( s[i] ) || ( i > 0 && s[i] == 'y' ) )
+                    return true;
+            return false;
+        }
+
+        /**
+         * light english suffix stripping, in the spirit of porter's step 1.
+         * it only has to be consistent between indexing and querying, not linguistically perfect
+         */
+        static string stem( string w ){
+            size_t n = w.size();
+            if ( n <= 3 )
+                return w;
+
+            if ( endsWith( w.c_str() , "sses" ) )
+                w.resize( n - 2 );
+            else if ( endsWith( w.c_str() , "ies" ) )
+                w = w.substr( 0 , n - 3 ) + "y";
+            else if ( w[n-1] == 's' && w[n-2] != 's' && w[n-2] != 'u' )
+                w.resize( n - 1 );
+
+            n = w.size();
+            size_t cut = 0;
+            if ( endsWith( w.c_str() , "ing" ) && n > 5 && hasVowel( w , n - 3 ) )
+                cut = 3;
+            else if ( endsWith( w.c_str() , "ed" ) && n > 4 && hasVowel( w , n - 2 ) )
+                cut = 2;
+            else if ( endsWith( w.c_str() , "ly" ) && n > 4 )
+                cut = 2;
+
+            if ( cut ){
+                w.resize( n - cut );
+                n = w.size();
+                // running -> runn -> run
+                if ( n > 2 && w[n-1] == w[n-2] && ! isVowel( w[n-1] ) &&
+                     w[n-1] != 'l' && w[n-1] != 's' && w[n-1] != 'z' )
+                    w.resize( n - 1 );
+            }
+            return w;
+        }
+
+        /** adds weight to every term in text */
+        static void tokenize( const char * text , double weight , map<string,double>& terms , double& totalWeight ){
+            const unsigned char * p = (const unsigned char*)text;
+            while ( *p ){
+                while ( *p && ! isWordChar( *p ) )
+                    p++;
+                if ( ! *p )
+                    break;
+
+                string word;
+                while ( *p && isWordChar( *p ) ){
+                    word += (char)tolower( *p );
+                    p++;
+                }
+
+                if ( word.size() > MaxTermLength || isStopWord( word ) )
+                    continue;
+
+                terms[ stem( word ) ] += weight;
+                totalWeight += weight;
+            }
+        }
+
+        /** term -> weight of that term in obj, normalized for document length */
+        void termWeights( const BSONObj& obj , map<string,double>& terms ) const {
+            double total = 0;
+            for ( unsigned i=0; i<_fields.size(); i++ ){
+                BSONElementSet all;
+                obj.getFieldsDotted( _fields[i].c_str() , all );
+                for ( BSONElementSet::iterator j=all.begin(); j!=all.end(); ++j ){
+                    if ( j->type() == String )
+                        tokenize( j->valuestr() , _weights[i] , terms , total );
+                }
+            }
+
+            if ( total == 0 )
+                return;
+
+            double norm = sqrt( total );
+            for ( map<string,double>::iterator i=terms.begin(); i!=terms.end(); ++i )
+                i->second /= norm;
+        }
+
+        // ---- IndexType ----
+
+        void getKeys( const BSONObj &obj, BSONObjSetDefaultOrder &keys ) const {
+            map<string,double> terms;
+            termWeights( obj , terms );
+
+            for ( map<string,double>::iterator i=terms.begin(); i!=terms.end(); ++i ){
+                BSONObjBuilder b;
+                b.append( "" , i->first );
+                b.append( "" , i->second );
+                keys.insert( b.obj() );
+            }
+        }
+
+        shared_ptr<Cursor> newCursor( const BSONObj& query , const BSONObj& order , int numWanted ) const;
+
+        /** only a $text query on one of our fields can use this index */
+        IndexSuitability suitability( const BSONObj& query , const BSONObj& order ) const {
+            return textQuery( query ).eoo() ? USELESS : OPTIMAL;
+        }
+
+        /** @return the $text element of query, or eoo */
+        BSONElement textQuery( const BSONObj& query ) const {
+            for ( unsigned i=0; i<_fields.size(); i++ ){
+                BSONElement e = query[_fields[i]];
+                if ( e.type() != Object )
+                    continue;
+                BSONElement t = e.embeddedObject().firstElement();
+                if ( t.getGtLtOp() == BSONObj::opTEXT )
+                    return t;
+            }
+            return BSONElement();
+        }
+
+        // ---- searching ----
+
+        /**
+         * scores every document containing at least one of the query terms
+         * score = sum over terms of ( weight of term in doc * log( 1 + nrecords / docs with term ) )
+         * @param limit 0 for all
+         */
+        void search( const string& text , unsigned limit , FTSResults& results , long long& nscanned ) const {
+            const IndexDetails * id = getDetails();
+            NamespaceDetails * d = nsdetails( id->parentNS().c_str() );
+            assert( d );
+            int idxNo = d->idxNo( *(IndexDetails*)id );
+
+            map<string,double> queryTerms;
+            double ignore = 0;
+            tokenize( text.c_str() , 1 , queryTerms , ignore );
+
+            double nrecords = max( 1LL , d->stats.nrecords );
+
+            map<DiskLoc,double> scores;
+            for ( map<string,double>::iterator i=queryTerms.begin(); i!=queryTerms.end(); ++i ){
+                BSONObjBuilder s;
+                s.append( "" , i->first );
+                s.appendMinKey( "" );
+                BSONObjBuilder e;
+                e.append( "" , i->first );
+                e.appendMaxKey( "" );
+
+                vector< pair<DiskLoc,double> > postings;
+                BtreeCursor c( d , idxNo , *id , s.obj() , e.obj() , true , 1 );
+                while ( c.ok() ){
+                    BSONObjIterator k( c.currKey() );
+                    k.next();
+                    postings.push_back( make_pair( c.currLoc() , k.next().numberDouble() ) );
+                    nscanned++;
+                    c.advance();
+                }
+                FTSDEBUG( "term: " << i->first << " docs: " << postings.size() );
+
+                if ( postings.empty() )
+                    continue;
+
+                double idf = ::log( 1 + nrecords / postings.size() );
+                for ( unsigned j=0; j<postings.size(); j++ )
+                    scores[postings[j].first] += postings[j].second * idf;
+            }
+
+            results.reserve( scores.size() );
+            for ( map<DiskLoc,double>::iterator i=scores.begin(); i!=scores.end(); ++i )
+                results.push_back( FTSScore( i->first , i->second ) );
+
+            if ( limit && limit < results.size() ){
+                partial_sort( results.begin() , results.begin() + limit , results.end() );
+                results.resize( limit );
+            }
+            else {
+                sort( results.begin() , results.end() );
+            }
+        }
+
+        const IndexDetails* getDetails() const {
+            return _spec->getDetails();
+        }
+
+        // terms longer than this aren't indexed, keeps keys well under the btree limit
+        static const size_t MaxTermLength = 64;
+
+    private:
+        vector<string> _fields;
+        vector<double> _weights;
+    };
+
+    class FTSCursor : public Cursor {
+    public:
+        FTSCursor( const FTSIndex * spec , shared_ptr<FTSResults> results , long long nscanned )
+            : _spec( spec ) , _results( results ) , _cur( results->begin() ) , _end( results->end() ) , _nscanned( nscanned ){
+        }
+
+        virtual bool ok(){ return _cur != _end; }
+        virtual Record* _current(){ assert(ok()); return _cur->_loc.rec(); }
+        virtual BSONObj current(){ assert(ok()); return _cur->_loc.obj(); }
+        virtual DiskLoc currLoc(){ assert(ok()); return _cur->_loc; }
+        virtual bool advance(){ _cur++; return ok(); }
+
+        virtual DiskLoc refLoc(){ return DiskLoc(); }
+
+        virtual BSONObj indexKeyPattern() {
+            return _spec->keyPattern();
+        }
+
+        virtual void noteLocation() {
+            // no-op since these are meant to be safe
+        }
+
+        virtual void checkLocation() {
+            // no-op since these are meant to be safe
+        }
+
+        virtual bool supportGetMore() { return false; }
+        virtual bool supportYields() { return false; }
+
+        virtual bool getsetdup(DiskLoc loc) { return false; }
+        virtual bool modifiedKeys() const { return true; }
+
+        virtual string toString() {
+            return "FTSCursor";
+        }
+
+        virtual long long nscanned() { return _nscanned; }
+
+    private:
+        const FTSIndex * _spec;
+        shared_ptr<FTSResults> _results;
+        FTSResults::iterator _cur;
+        FTSResults::iterator _end;
+        long long _nscanned;
+    };
+
+    shared_ptr<Cursor> FTSIndex::newCursor( const BSONObj& query , const BSONObj& order , int numWanted ) const {
+        BSONElement e = textQuery( query );
+        uassert( 13533 , (string)"missing $text in : " + query.toString() , ! e.eoo() );
+        uassert( 13534 , "$text needs a string" , e.type() == String );
+
+        // other query fields are matched afterwards, so don't cut the result list short
+        shared_ptr<FTSResults> results( new FTSResults() );
+        long long nscanned = 0;
+        search( e.String() , 0 , *results , nscanned );
+        return shared_ptr<Cursor>( new FTSCursor( this , results , nscanned ) );
+    }
+
+    class FTSIndexPlugin : public IndexPlugin {
+    public:
+        FTSIndexPlugin() : IndexPlugin( FTSNAME ){
+        }
+
+        virtual IndexType* generate( const IndexSpec* spec ) const {
+            return new FTSIndex( this , spec );
+        }
+
+    } ftsIndexPlugin;
+
+    class FTSSearchCommand : public Command {
+    public:
+        FTSSearchCommand() : Command( "textSearch" ){}
+        virtual LockType locktype() const { return READ; }
+        bool slaveOk() const { return true; }
+        bool slaveOverrideOk() const { return true; }
+        void help(stringstream& h) const {
+            h << "search a text index, results are ranked by score\n"
+              << "{ textSearch : <collection> , search : <string> [, limit : <n>] [, filter : <query>] }";
+        }
+        bool run(const string& dbname , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl){
+            string ns = dbname + "." + cmdObj.firstElement().valuestr();
+
+            NamespaceDetails * d = nsdetails( ns.c_str() );
+            if ( ! d ){
+                errmsg = "can't find ns";
+                return false;
+            }
+
+            vector<int> idxs;
+            d->findIndexByType( FTSNAME , idxs );
+            if ( idxs.size() == 0 ){
+                errmsg = "no text index";
+                return false;
+            }
+            if ( idxs.size() > 1 ){
+                errmsg = "more than 1 text index";
+                return false;
+            }
+
+            IndexDetails& id = d->idx( idxs[0] );
+            FTSIndex * fts = (FTSIndex*)id.getSpec().getType();
+            assert( &id == fts->getDetails() );
+
+            BSONElement search = cmdObj["search"];
+            uassert( 13535 , "search needs to be a string" , search.type() == String );
+
+            unsigned limit = 100;
+            if ( cmdObj["limit"].isNumber() ){
+                int l = cmdObj["limit"].numberInt();
+                uassert( 13549 , "limit can't be negative" , l >= 0 );
+                limit = (unsigned)l;
+            }
+
+            auto_ptr<Matcher> filter;
+            if ( cmdObj["filter"].type() == Object )
+                filter.reset( new Matcher( cmdObj["filter"].embeddedObject() ) );
+
+            Timer t;
+            FTSResults results;
+            long long nscanned = 0;
+            // with a filter we don't know how many will survive, so score everything
+            fts->search( search.String() , filter.get() ? 0 : limit , results , nscanned );
+
+            BSONArrayBuilder arr( result.subarrayStart( "results" ) );
+            unsigned n = 0;
+            for ( unsigned i=0; i<results.size() && ( limit == 0 || n < limit ); i++ ){
+                BSONObj o = results[i]._loc.obj();
+                if ( filter.get() && ! filter->matches( o ) )
+                    continue;
+                BSONObjBuilder bb( arr.subobjStart() );
+                bb.append( "score" , results[i]._score );
+                bb.append( "obj" , o );
+                bb.done();
+                n++;
+            }
+            arr.done();
+
+            BSONObjBuilder stats( result.subobjStart( "stats" ) );
+            stats.append( "time" , t.millis() );
+            stats.appendNumber( "nscanned" , nscanned );
+            stats.appendNumber( "nscored" , (long long)results.size() );
+            stats.append( "n" , n );
+            stats.done();
+
+            return true;
+        }
+
+    } ftsSearchCommand;
+
+    struct FTSUnitTest : public UnitTest {
+        void run(){
+            assert( FTSIndex::stem( "shoes" ) == "shoe" );
+            assert( FTSIndex::stem( "running" ) == "run" );
+            assert( FTSIndex::stem( "ponies" ) == "pony" );
+            assert( FTSIndex::stem( "glass" ) == "glass" );
+            assert( FTSIndex::stem( "jumped" ) == "jump" );
+
+            map<string,double> terms;
+            double total = 0;
+            FTSIndex::tokenize( "The quick, brown fox; the QUICK dogs." , 1 , terms , total );
+            assert( terms.size() == 4 );
+            assert( terms["quick"] == 2 );
+            assert( terms["dog"] == 1 );
+            assert( terms.count( "the" ) == 0 );
+            assert( total == 5 );
+        }
+    } ftsUnitTest;
+
+}
@@ -38,6 +38,7 @@
 #endif
 #include "stats/counters.h"
 #include "background.h"
+#include "admission.h"
 
 namespace mongo {
 
@@ -101,8 +102,18 @@ namespace mongo {
                         continue;
                     }
                     assert( co );
-                    if( all || co->active() )
-                        vals.push_back( co->infoNoauth() );
+                    if( all || co->active() ) {
+                        BSONObj info = co->infoNoauth();
+                        if ( c->_mp && c->_mp->compressing() ) {
+                            BSONObjBuilder x;
+                            x.appendElements( info );
+                            BSONObjBuilder s( x.subobjStart( "compression" ) );
+                            c->_mp->appendCompressionStats( s );
+                            s.done();
+                            info = x.obj();
+                        }
+                        vals.push_back( info );
+                    }
                 }
             }
             b.append("inprog", vals);
@@ -158,6 +169,31 @@ namespace mongo {
         replyToQuery(0, m, dbresponse, obj);
     }
 
+    /* a reply carrying just the error of a query that failed */
+    static void errorReply( AssertionException& e , Message& resp ) {
+        BSONObjBuilder err;
+        e.getInfo().append( err );
+        BSONObj errObj = err.done();
+
+        BufBuilder b;
+        b.skip(sizeof(QueryResult));
+        b.appendBuf((void*) errObj.objdata(), errObj.objsize());
+
+        // todo: call replyToQuery() from here instead of this!!! see dbmessage.h
+        QueryResult * msgdata = (QueryResult *) b.buf();
+        b.decouple();
+        QueryResult *qr = msgdata;
+        qr->_resultFlags() = ResultFlag_ErrSet;
+        if ( e.getCode() == StaleConfigInContextCode )
+            qr->_resultFlags() |= ResultFlag_ShardConfigStale;
+        qr->len = b.len();
+        qr->setOperation(opReply);
+        qr->cursorId = 0;
+        qr->startingFrom = 0;
+        qr->nReturned = 1;
+        resp.setData( msgdata, true );
+    }
+
     static bool receivedQuery(Client& c, DbResponse& dbresponse, Message& m ){
         bool ok = true;
         MSGID responseTo = m.header()->id;
@@ -182,28 +218,8 @@ namespace mongo {
                     log() << " ntoskip:" << q.ntoskip << " ntoreturn:" << q.ntoreturn << endl;
             }
 
-            BSONObjBuilder err;
-            e.getInfo().append( err );
-            BSONObj errObj = err.done();
-
-            BufBuilder b;
-            b.skip(sizeof(QueryResult));
-            b.appendBuf((void*) errObj.objdata(), errObj.objsize());
-
-            // todo: call replyToQuery() from here instead of this!!! see dbmessage.h
-            QueryResult * msgdata = (QueryResult *) b.buf();
-            b.decouple();
-            QueryResult *qr = msgdata;
-            qr->_resultFlags() = ResultFlag_ErrSet;
-            if ( e.getCode() == StaleConfigInContextCode )
-                qr->_resultFlags() |= ResultFlag_ShardConfigStale;
-            qr->len = b.len();
-            qr->setOperation(opReply);
-            qr->cursorId = 0;
-            qr->startingFrom = 0;
-            qr->nReturned = 1;
             resp.reset( new Message() );
-            resp->setData( msgdata, true );
+            errorReply( e , *resp );
         }
 
         if ( op.shouldDBProfile( 0 ) ){
@@ -264,12 +280,33 @@ namespace mongo {
             currentOpP = nestedOp.get();
         }
         CurOp& currentOp = *currentOpP;
+
+        // before waiting for a ticket, so a queued op shows up in currentOp and can be killed
         currentOp.reset(client,op);
         
         OpDebug& debug = currentOp.debug();
         StringBuilder& ss = debug.str;
         ss << opToString( op ) << " ";
 
+        // nested operations (DBDirectClient) run under their parent's ticket
+        auto_ptr<Admission::Ticket> ticket;
+        try {
+            ticket.reset( new Admission::Ticket( admission , nestedOp.get() ? Admission::Unthrottled : Admission::classify( m ) ) );
+        }
+        catch ( AssertionException& e ) {
+            // killed or shutting down while queued; writes report it through getLastError
+            ss << " exception " << e.toString();
+            if ( op == dbQuery || op == dbGetMore ) {
+                Message *resp = new Message();
+                errorReply( e , *resp );
+                dbresponse.response = resp;
+                dbresponse.responseTo = m.header()->id;
+            }
+            currentOp.ensureStarted();
+            currentOp.done();
+            return true;
+        }
+
         int logThreshold = cmdLine.slowMS;
         bool log = logLevel >= 1;
         
@@ -550,7 +587,7 @@ namespace mongo {
         };
 
         Message *resp = new Message();
-        resp->setData(msgdata, true);
+        resp->setData(msgdata, true, true); // processGetMore() and emptyMoreResult() use bufferPool
         ss << " bytes:" << resp->header()->dataLen();
         ss << " nreturned:" << msgdata->nReturned;
         dbresponse.response = resp;
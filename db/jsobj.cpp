@@ -293,6 +293,8 @@ namespace mongo {
             }
             else if ( fn[1] == 't' && fn[2] == 'y' && fn[3] == 'p' && fn[4] == 'e' && fn[5] == 0 )
                 return BSONObj::opTYPE;
+            else if ( fn[1] == 't' && fn[2] == 'e' && fn[3] == 'x' && fn[4] == 't' && fn[5] == 0 )
+                return BSONObj::opTEXT;
             else if ( fn[1] == 'i' && fn[2] == 'n' && fn[3] == 0 )
                 return BSONObj::opIN;
             else if ( fn[1] == 'n' && fn[2] == 'i' && fn[3] == 'n' && fn[4] == 0 )
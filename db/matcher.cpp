@@ -261,6 +261,7 @@ namespace mongo {
             case BSONObj::opNEAR:
             case BSONObj::opWITHIN:
             case BSONObj::opMAX_DISTANCE:
+            case BSONObj::opTEXT:
                 break;
             default:
                 uassert( 10069 ,  (string)"BUG - can't operator for: " + fn , 0 );
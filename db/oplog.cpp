@@ -23,13 +23,12 @@
 #include "commands.h"
 #include "repl/rs.h"
 #include "stats/counters.h"
+#include "btree.h"
 
 namespace mongo {
 
     void logOpForSharding( const char * opstr , const char * ns , const BSONObj& obj , BSONObj * patt );
 
-    int __findingStartInitialTimeout = 5; // configurable for testing    
-
     // cached copies of these...so don't rename them, drop them, etc.!!!
     static NamespaceDetails *localOplogMainDetails = 0;
     static Database *localDB = 0;
@@ -83,6 +82,36 @@ namespace mongo {
         }
     }
 
+    void _logOpObjsRS(const vector<BSONObj>& ops, unsigned from, unsigned to) { 
+        DEV assertInWriteLock();
+        if( from >= to )
+            return;
+
+        const char *logns = rsoplog;
+        if ( rsOplogDetails == 0 ) {
+            _logOpObjRS(ops[from++]); // looks up the oplog
+            if( from >= to )
+                return;
+        }
+        Client::Context ctx( logns , localDB, false );
+        for( unsigned i = from; i < to; i++ ) {
+            int len = ops[i].objsize();
+            Record *r = theDataFileMgr.fast_oplog_insert(rsOplogDetails, logns, len);
+            memcpy(r->data, ops[i].objdata(), len);
+        }
+
+        const BSONObj& last = ops[to-1];
+        const OpTime ts = last["ts"]._opTime();
+        if( theReplSet ) {
+            if( !(theReplSet->lastOpTimeWritten<ts) ) {
+                log() << "replSet error possible failover clock skew issue? " << theReplSet->lastOpTimeWritten.toString() << ' ' << endl;
+            }
+            theReplSet->lastOpTimeWritten = ts;
+            theReplSet->lastH = last["h"].numberLong();
+            ctx.getClient()->setLastOp( ts.asDate() );
+        }
+    }
+
     static void _logOpRS(const char *opstr, const char *ns, const char *logNS, const BSONObj& obj, BSONObj *o2, bool *bb ) {
         DEV assertInWriteLock();
         static BufBuilder bufbuilder(8*1024);
@@ -395,40 +424,63 @@ namespace mongo {
 
     int _dummy_z;
 
+    /* faults in the btree buckets that inserting obj into d's indexes goes through */
+    static void pretouchIndexes(NamespaceDetails *d, const BSONObj& obj) { 
+        for( int i = 0; i < d->nIndexes; i++ ) {
+            IndexDetails& idx = d->idx(i);
+            BSONObjSetDefaultOrder keys;
+            idx.getKeysFromObject(obj, keys);
+            Ordering order = Ordering::make(idx.keyPattern());
+            for( BSONObjSetDefaultOrder::iterator k = keys.begin(); k != keys.end(); k++ ) {
+                int pos;
+                bool found;
+                idx.head.btree()->locate(idx, idx.head, *k, order, pos, found, minDiskLoc);
+            }
+        }
+    }
+
+    /* faults in what applying op will touch: for an update or delete the document (through the _id index), 
+       for an insert the index buckets its keys go in.  caller read locks. */
+    static void _pretouch(const BSONObj& op) { 
+        const char *which = "o";
+        const char *opType = op.getStringField("op");
+        if ( *opType == 'i' || *opType == 'd' )
+            ;
+        else if( *opType == 'u' )
+            which = "o2";
+        else
+            return;
+        /* todo : other operations */
+
+        const char *ns = op.getStringField("ns");
+        BSONObj o = op.getObjectField(which);
+        Client::Context ctx( ns );
+        if( *opType == 'i' ) { 
+            NamespaceDetails *d = nsdetails(ns);
+            if( d )
+                pretouchIndexes(d, o);
+            return;
+        }
+        BSONElement _id;
+        if( o.getObjectID(_id) ) {
+            BSONObjBuilder b;
+            b.append(_id);
+            BSONObj result;
+            if( Helpers::findById(cc(), ns, b.done(), result) )
+                _dummy_z += result.objsize(); // touch
+        }
+    }
+
     void pretouchN(vector<BSONObj>& v, unsigned a, unsigned b) {
         DEV assert( !dbMutex.isWriteLocked() );
 
-        Client *c = &cc();
-        if( c == 0 ) { 
+        if( currentClient.get() == 0 )
             Client::initThread("pretouchN");
-            c = &cc();
-        }
 
         readlock lk("");
         for( unsigned i = a; i <= b; i++ ) {
-            const BSONObj& op = v[i];
-            const char *which = "o";
-            const char *opType = op.getStringField("op");
-            if ( *opType == 'i' )
-                ;
-            else if( *opType == 'u' )
-                which = "o2";
-            else
-                continue;
-            /* todo : other operations */
-
             try { 
-                BSONObj o = op.getObjectField(which);
-                BSONElement _id;
-                if( o.getObjectID(_id) ) {
-                    const char *ns = op.getStringField("ns");
-                    BSONObjBuilder b;
-                    b.append(_id);
-                    BSONObj result;
-                    Client::Context ctx( ns );
-                    if( Helpers::findById(cc(), ns, b.done(), result) )
-                        _dummy_z += result.objsize(); // touch
-                }
+                _pretouch(v[i]);
             }
             catch( DBException& e ) { 
                 log() << "ignoring assertion in pretouchN() " << a << ' ' << b << ' ' << i << ' ' << e.toString() << endl;
@@ -441,29 +493,9 @@ namespace mongo {
         if( dbMutex.isWriteLocked() )
             return; // no point pretouching if write locked. not sure if this will ever fire, but just in case.
 
-        const char *which = "o";
-        const char *opType = op.getStringField("op");
-        if ( *opType == 'i' )
-            ;
-        else if( *opType == 'u' )
-            which = "o2";
-        else
-            return;
-        /* todo : other operations */
-
         try { 
-            BSONObj o = op.getObjectField(which);
-            BSONElement _id;
-            if( o.getObjectID(_id) ) {
-                const char *ns = op.getStringField("ns");
-                BSONObjBuilder b;
-                b.append(_id);
-                BSONObj result;
-                readlock lk(ns);
-                Client::Context ctx( ns );
-                if( Helpers::findById(cc(), ns, b.done(), result) )
-                    _dummy_z += result.objsize(); // touch
-            }
+            readlock lk(op.getStringField("ns"));
+            _pretouch(op);
         }
         catch( DBException& ) { 
             log() << "ignoring assertion in pretouchOperation()" << endl;
@@ -37,6 +37,8 @@ namespace mongo {
     void createOplog();
 
     void _logOpObjRS(const BSONObj& op);
+    /** _logOpObjRS() for ops[from..to) */
+    void _logOpObjsRS(const vector<BSONObj>& ops, unsigned from, unsigned to);
 
     /** Write operation to the log (local.oplog.$main)
       
@@ -62,15 +64,16 @@ namespace mongo {
 
     void oplogCheckCloseDatabase( Database * db );
     
-    extern int __findingStartInitialTimeout; // configurable for testing    
-
+    /* finds where in a capped collection a query with QueryOption_OplogReplay should start: the first record 
+       in its ts range.  records are in ts order, so we binary search the extents by their first record, 
+       which looks at O(log #extents) records, and then scan only the extent the start is in.  the scan 
+       uses a ClientCursor so we can yield during it.
+    */
     class FindingStartCursor {
     public:
         FindingStartCursor( const QueryPlan & qp ) : 
         _qp( qp ),
         _findingStart( true ),
-        _findingStartMode(),
-        _findingStartTimer( 0 ),
         _findingStartCursor( 0 )
         { init(); }
         bool done() const { return !_findingStart; }
@@ -82,54 +85,13 @@ namespace mongo {
                 destroyClientCursor();
                 return;
             }
-            switch( _findingStartMode ) {
-                case Initial: {
-                    if ( !_matcher->matches( _findingStartCursor->currKey(), _findingStartCursor->currLoc() ) ) {
-                        _findingStart = false; // found first record out of query range, so scan normally
-                        _c = _qp.newCursor( _findingStartCursor->currLoc() );
-                        destroyClientCursor();
-                        return;
-                    }
-                    _findingStartCursor->advance();
-                    RARELY {
-                        if ( _findingStartTimer.seconds() >= __findingStartInitialTimeout ) {
-                            createClientCursor( startLoc( _findingStartCursor->currLoc() ) );
-                            _findingStartMode = FindExtent;
-                            return;
-                        }
-                    }
-                    return;
-                }
-                case FindExtent: {
-                    if ( !_matcher->matches( _findingStartCursor->currKey(), _findingStartCursor->currLoc() ) ) {
-                        _findingStartMode = InExtent;
-                        return;
-                    }
-                    DiskLoc prev = prevLoc( _findingStartCursor->currLoc() );
-                    if ( prev.isNull() ) { // hit beginning, so start scanning from here
-                        createClientCursor();
-                        _findingStartMode = InExtent;
-                        return;
-                    }
-                    // There might be a more efficient implementation than creating new cursor & client cursor each time,
-                    // not worrying about that for now
-                    createClientCursor( prev );
-                    return;
-                }
-                case InExtent: {
-                    if ( _matcher->matches( _findingStartCursor->currKey(), _findingStartCursor->currLoc() ) ) {
-                        _findingStart = false; // found first record in query range, so scan normally
-                        _c = _qp.newCursor( _findingStartCursor->currLoc() );
-                        destroyClientCursor();
-                        return;
-                    }
-                    _findingStartCursor->advance();
-                    return;
-                }
-                default: {
-                    massert( 12600, "invalid _findingStartMode", false );
-                }
-            }                
+            if ( _matcher->matches( _findingStartCursor->currKey(), _findingStartCursor->currLoc() ) ) {
+                _findingStart = false; // found first record in query range, so scan normally
+                _c = _qp.newCursor( _findingStartCursor->currLoc() );
+                destroyClientCursor();
+                return;
+            }
+            _findingStartCursor->advance();
         }     
         bool prepareToYield() {
             if ( _findingStartCursor ) {
@@ -145,43 +107,38 @@ namespace mongo {
             }
         }        
     private:
-        enum FindingStartMode { Initial, FindExtent, InExtent };
         const QueryPlan &_qp;
         bool _findingStart;
-        FindingStartMode _findingStartMode;
         auto_ptr< CoveredIndexMatcher > _matcher;
-        Timer _findingStartTimer;
         ClientCursor * _findingStartCursor;
         shared_ptr<Cursor> _c;
         ClientCursor::YieldData _yieldData;
-        DiskLoc startLoc( const DiskLoc &rec ) {
-            Extent *e = rec.rec()->myExtent( rec );
-            if ( !_qp.nsd()->capLooped() || ( e->myLoc != _qp.nsd()->capExtent ) )
-                return e->firstRecord;
-            // Likely we are on the fresh side of capExtent, so return first fresh record.
-            // If we are on the stale side of capExtent, then the collection is small and it
-            // doesn't matter if we start the extent scan with capFirstNewRecord.
-            return _qp.nsd()->capFirstNewRecord;
+
+        Extent *nextLoop( Extent *e ) {
+            return e->xnext.isNull() ? _qp.nsd()->firstExtent.ext() : e->xnext.ext();
         }
-        
-        // should never have an empty extent in the oplog, so don't worry about that case
-        DiskLoc prevLoc( const DiskLoc &rec ) {
-            Extent *e = rec.rec()->myExtent( rec );
-            if ( _qp.nsd()->capLooped() ) {
-                if ( e->xprev.isNull() )
-                    e = _qp.nsd()->lastExtent.ext();
-                else
-                    e = e->xprev.ext();
-                if ( e->myLoc != _qp.nsd()->capExtent )
-                    return e->firstRecord;
-            } else {
-                if ( !e->xprev.isNull() ) {
-                    e = e->xprev.ext();
-                    return e->firstRecord;
-                }
+
+        /* where the records of each extent start, oldest first.  once a capped collection has looped, 
+           the front of capExtent holds its oldest records and capFirstNewRecord on its newest, so capExtent 
+           is in here twice: at the start and at the end. */
+        void extentStarts( vector<DiskLoc>& v ) {
+            NamespaceDetails *d = _qp.nsd();
+            if ( !d->capLooped() ) {
+                for ( Extent *e = d->firstExtent.ext(); e; e = e->getNextExtent() )
+                    if ( !e->firstRecord.isNull() )
+                        v.push_back( e->firstRecord );
+                return;
             }
-            return DiskLoc(); // reached beginning of collection
+            Extent *cap = d->capExtent.ext();
+            if ( !cap->firstRecord.isNull() && cap->firstRecord != d->capFirstNewRecord )
+                v.push_back( cap->firstRecord );
+            for ( Extent *e = nextLoop( cap ); e != cap; e = nextLoop( e ) )
+                if ( !e->firstRecord.isNull() )
+                    v.push_back( e->firstRecord );
+            if ( !d->capFirstNewRecord.isNull() )
+                v.push_back( d->capFirstNewRecord );
         }
+
         void createClientCursor( const DiskLoc &startLoc = DiskLoc() ) {
             shared_ptr<Cursor> c = _qp.newCursor( startLoc );
             _findingStartCursor = new ClientCursor(QueryOption_NoCursorTimeout, c, _qp.ns());
@@ -193,18 +150,33 @@ namespace mongo {
             }
         }
         void init() {
-            // Use a ClientCursor here so we can release db mutex while scanning
-            // oplog (can take quite a while with large oplogs).
-            shared_ptr<Cursor> c = _qp.newReverseCursor();
-            _findingStartCursor = new ClientCursor(QueryOption_NoCursorTimeout, c, _qp.ns(), BSONObj());
-            _findingStartTimer.reset();
-            _findingStartMode = Initial;
             BSONElement tsElt = _qp.originalQuery()[ "ts" ];
             massert( 13044, "no ts field in query", !tsElt.eoo() );
             BSONObjBuilder b;
             b.append( tsElt );
             BSONObj tsQuery = b.obj();
             _matcher.reset(new CoveredIndexMatcher(tsQuery, _qp.indexKey()));
+
+            vector<DiskLoc> starts;
+            if ( _qp.nsd() )
+                extentStarts( starts );
+
+            // the first extent that starts in the query range, the query starts in the one before it
+            unsigned lo = 0, hi = starts.size();
+            while ( lo < hi ) {
+                unsigned mid = ( lo + hi ) / 2;
+                if ( _matcher->matches( starts[ mid ].obj() ) )
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            if ( lo == 0 ) { // the oldest record is in range, or there are none
+                _findingStart = false;
+                _c = _qp.newCursor();
+                return;
+            }
+            // Use a ClientCursor here so we can release db mutex while scanning the extent
+            createClientCursor( starts[ lo - 1 ] );
         }
     };
 
@@ -14,21 +14,43 @@ namespace mongo {
     class OplogReader {
         auto_ptr<DBClientConnection> _conn;
         auto_ptr<DBClientCursor> cursor;
+        string _host;
+        bool _exhaust;
+
+        /* an exhaust cursor that isn't done has the server still sending batches on the connection */
+        bool streaming() { return _exhaust && cursor.get() && cursor->getCursorId() != 0; }
     public:
 
-        OplogReader() { 
+        OplogReader() : _exhaust(false) { 
         }
         ~OplogReader() { 
         }
 
         void resetCursor() {
+            bool drop = streaming();
             cursor.reset();
+            if( drop ) {
+                // can't stop the server mid stream, so drop the connection.  conn() makes a new one.
+                log(1) << "repl: dropping connection to " << _host << " to end exhaust cursor" << endl;
+                _conn.reset();
+            }
+            _exhaust = false;
         }
         void resetConnection() {
             cursor.reset();
             _conn.reset();
+            _host.clear();
+            _exhaust = false;
+        }
+        DBClientConnection* conn() { 
+            if( streaming() )
+                resetCursor();
+            if( _conn.get() == 0 && !_host.empty() ) {
+                string h = _host; // connect() clears it if it fails
+                uassert( 13545 , "repl: couldn't reconnect to " + h , connect(h) );
+            }
+            return _conn.get(); 
         }
-        DBClientConnection* conn() { return _conn.get(); }
         BSONObj findOne(const char *ns, const Query& q) { 
             return conn()->findOne(ns, q, 0, QueryOption_SlaveOk);
         }
@@ -49,27 +71,30 @@ namespace mongo {
 
         bool haveCursor() { return cursor.get() != 0; }
 
-        void query(const char *ns, const BSONObj& query) { 
+        /* exhaust: have the server send batches without waiting for getMores, if it can.  until the 
+           cursor is done, using conn() (or findOne etc.) drops it and reconnects.
+        */
+        void query(const char *ns, const BSONObj& query, bool exhaust = false) { 
             assert( !haveCursor() );
-            cursor = _conn->query(ns, query, 0, 0, 0, QueryOption_SlaveOk);
+            cursor = _conn->query(ns, query, 0, 0, 0, QueryOption_SlaveOk | exhaustOption(exhaust));
         }
 
-        void tailingQuery(const char *ns, const BSONObj& query) { 
+        void tailingQuery(const char *ns, const BSONObj& query, bool exhaust = false) { 
             assert( !haveCursor() );
             log(2) << "repl: " << ns << ".find(" << query.toString() << ')' << endl;
             cursor = _conn->query( ns, query, 0, 0, 0, 
                                   QueryOption_CursorTailable | QueryOption_SlaveOk | QueryOption_OplogReplay |
                                   /* TODO: slaveok maybe shouldn't use? */
-                                  QueryOption_AwaitData
+                                  QueryOption_AwaitData | exhaustOption(exhaust)
                                   );
         }
 
-        void tailingQueryGTE(const char *ns, OpTime t) {
+        void tailingQueryGTE(const char *ns, OpTime t, bool exhaust = false) {
             BSONObjBuilder q;
             q.appendDate("$gte", t.asDate());
             BSONObjBuilder query;
             query.append("ts", q.done());
-            tailingQuery(ns, query.done());
+            tailingQuery(ns, query.done(), exhaust);
         }
 
         bool more() { 
@@ -100,6 +125,12 @@ namespace mongo {
         void putBack(BSONObj op) { 
             cursor->putBack(op);
         }
+
+    private:
+        int exhaustOption(bool exhaust) {
+            _exhaust = exhaust && ( _conn->availableOptions() & QueryOption_Exhaust );
+            return _exhaust ? QueryOption_Exhaust : 0;
+        }
     };
     
 }
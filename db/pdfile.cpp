@@ -794,6 +794,27 @@ namespace mongo {
     
     int nUnindexes = 0;
 
+    /* remove one key of record dl (whose object is obj) from the index, logging any failure. */
+    static void _unindexKey(IndexDetails& id, const BSONObj& obj, const BSONObj& key, const DiskLoc& dl, bool logMissing) {
+        nUnindexes++;
+        bool ok = false;
+        try {
+            ok = id.head.btree()->unindex(id.head, id, key, dl);
+        }
+        catch (AssertionException& e) {
+            problem() << "Assertion failure: _unindex failed " << id.indexNamespace() << endl;
+            out() << "Assertion failure: _unindex failed: " << e.what() << '\n';
+            out() << "  obj:" << obj.toString() << '\n';
+            out() << "  key:" << key.toString() << '\n';
+            out() << "  dl:" << dl.toString() << endl;
+            sayDbContext();
+        }
+
+        if ( !ok && logMissing ) {
+            out() << "unindex failed (key too big?) " << id.indexNamespace() << '\n';
+        }
+    }
+
     /* unindex all keys in index for this record. */
     static void _unindexRecord(IndexDetails& id, BSONObj& obj, const DiskLoc& dl, bool logMissing = true) {
         BSONObjSetDefaultOrder keys;
@@ -804,23 +825,7 @@ namespace mongo {
                 out() << "_unindexRecord() " << obj.toString();
                 out() << "\n  unindex:" << j.toString() << endl;
             }
-            nUnindexes++;
-            bool ok = false;
-            try {
-                ok = id.head.btree()->unindex(id.head, id, j, dl);
-            }
-            catch (AssertionException& e) {
-                problem() << "Assertion failure: _unindex failed " << id.indexNamespace() << endl;
-                out() << "Assertion failure: _unindex failed: " << e.what() << '\n';
-                out() << "  obj:" << obj.toString() << '\n';
-                out() << "  key:" << j.toString() << '\n';
-                out() << "  dl:" << dl.toString() << endl;
-                sayDbContext();
-            }
-
-            if ( !ok && logMissing ) {
-                out() << "unindex failed (key too big?) " << id.indexNamespace() << '\n';
-            }
+            _unindexKey(id, obj, j, dl, logMissing);
         }
     }
 
@@ -836,6 +841,36 @@ namespace mongo {
         }
     }
 
+    class KeyAndLocCmp {
+    public:
+        KeyAndLocCmp( const BSONObj& keyPattern ) : _ordering( Ordering::make( keyPattern ) ){}
+        bool operator()( const pair<BSONObj,DiskLoc>& l , const pair<BSONObj,DiskLoc>& r ) const {
+            int x = l.first.woCompare( r.first , _ordering , false );
+            if ( x )
+                return x < 0;
+            return l.second < r.second;
+        }
+    private:
+        Ordering _ordering;
+    };
+
+    /* unindex all keys of a batch of records.  keys are removed in index order so consecutive 
+       removals mostly hit the same, already paged in, buckets. */
+    static void _unindexRecords(IndexDetails& id, const vector<DiskLoc>& locs, bool logMissing) {
+        vector< pair<BSONObj,DiskLoc> > all;
+        for ( unsigned i=0; i<locs.size(); i++ ) {
+            BSONObjSetDefaultOrder keys;
+            id.getKeysFromObject(locs[i].obj(), keys);
+            for ( BSONObjSetDefaultOrder::iterator k=keys.begin(); k != keys.end(); k++ )
+                all.push_back( make_pair( *k , locs[i] ) );
+        }
+
+        sort( all.begin() , all.end() , KeyAndLocCmp( id.keyPattern() ) );
+
+        for ( unsigned i=0; i<all.size(); i++ )
+            _unindexKey(id, all[i].second.obj(), all[i].first, all[i].second, logMissing);
+    }
+
     /* deletes a record, just the pdfile portion -- no index cleanup, no cursor cleanup, etc. 
        caller must check if capped
     */
@@ -913,6 +948,33 @@ namespace mongo {
         NamespaceDetailsTransient::get_w( ns ).notifyOfWriteOp();
     }
 
+    void DataFileMgr::deleteRecords(const char *ns, const vector<DiskLoc>& locs, bool noWarn)
+    {
+        if ( locs.empty() )
+            return;
+
+        NamespaceDetails* d = nsdetails(ns);
+        if ( d->capped ) {
+            out() << "failing remove on a capped ns " << ns << endl;
+            uassert( 13536 ,  "can't remove from a capped collection" , 0 );
+            return;
+        }
+
+        ClientCursor::aboutToDelete(locs);
+
+        int n = d->nIndexes;
+        for ( int i = 0; i < n; i++ )
+            _unindexRecords(d->idx(i), locs, !noWarn);
+        if( d->backgroundIndexBuildInProgress ) {
+            // always pass nowarn here, as this one may be missing for valid reasons as we are concurrently building it
+            _unindexRecords(d->idx(n), locs, false);
+        }
+
+        for ( unsigned i=0; i<locs.size(); i++ )
+            _deleteRecord(d, ns, locs[i].rec(), locs[i]);
+        NamespaceDetailsTransient::get_w( ns ).notifyOfWriteOp();
+    }
+
 
     /** Note: if the object shrinks a lot, we don't free up space, we leave extra at end of the record.
      */
@@ -1186,9 +1248,54 @@ namespace mongo {
 
     class BackgroundIndexBuildJob : public BackgroundOperation { 
 
-        unsigned long long addExistingToIndex(const char *ns, NamespaceDetails *d, IndexDetails& idx, int idxNo) {
+        typedef vector< pair<BSONObj,DiskLoc> > KeyBatch;
+
+        /* keys are gathered for this many documents (or bytes of keys) between yields, then put
+           into the btree in key order.  consecutive inserts then mostly hit the same, already paged
+           in, buckets rather than a random spot in the tree for every document.
+           128 is the yield interval the build always had, so writers wait no longer than before. */
+        enum { BatchDocs = 128 , BatchBytes = 16 * 1024 * 1024 };
+
+        /* insert a batch of keys, sorting it first.  records with a duplicate key are added to dups
+           when dropDups is set; otherwise the dup key exception propagates. */
+        void insertBatch(NamespaceDetails *d, IndexDetails& idx, int idxNo, KeyBatch& batch, set<DiskLoc>& dups) {
             bool dupsAllowed = !idx.unique();
             bool dropDups = idx.dropDups();
+            Ordering ordering = Ordering::make(idx.keyPattern());
+
+            sort( batch.begin() , batch.end() , KeyAndLocCmp( idx.keyPattern() ) );
+
+            for ( unsigned i=0; i<batch.size(); i++ ) {
+                const DiskLoc& loc = batch[i].second;
+                if ( dropDups && dups.count( loc ) )
+                    continue;
+                try {
+                    idx.head.btree()->bt_insert(idx.head, loc, batch[i].first, ordering, dupsAllowed, idx);
+                }
+                catch( AssertionException& e ) {
+                    if( e.interrupted() )
+                        throw;
+                    if( e.getCode() == 10287 && idxNo == d->nIndexes ) { 
+                        // a concurrent write indexed this record after our cursor picked it up
+                        DEV log() << "info: caught key already in index on bg indexing (ok)" << endl;
+                        continue;
+                    }
+                    if( dupsAllowed ) {
+                        problem() << " caught assertion _indexRecord " << idx.indexNamespace() << endl;
+                        continue;
+                    }
+                    if( !dropDups ) {
+                        log() << "background addExistingToIndex exception " << e.what() << endl;
+                        throw;
+                    }
+                    dups.insert( loc );
+                }
+            }
+            batch.clear();
+        }
+
+        unsigned long long addExistingToIndex(const char *ns, NamespaceDetails *d, IndexDetails& idx, int idxNo) {
+            bool dropDups = idx.dropDups();
 
             ProgressMeter& progress = cc().curop()->setMessage( "bg index build" , d->stats.nrecords );
 
@@ -1200,39 +1307,63 @@ namespace mongo {
             }
             CursorId id = cc->cursorid();
 
+            KeyBatch batch;
+            set<DiskLoc> dups;
+            int batchDocs = 0;
+            int batchBytes = 0;
+
             while ( cc->ok() ) {
                 BSONObj js = cc->current();
+                DiskLoc loc = cc->currLoc();
                 try { 
-                    _indexRecord(d, idxNo, js, cc->currLoc(), dupsAllowed);
-                    cc->advance();
-                } catch( AssertionException& e ) { 
-                    if( e.interrupted() )
-                        throw;
-
-                    if ( dropDups ) {
-                        DiskLoc toDelete = cc->currLoc();
-                        bool ok = cc->advance();
-                        cc->updateLocation();
-                        theDataFileMgr.deleteRecord( ns, toDelete.rec(), toDelete, false, true );
-                        if( ClientCursor::find(id, false) == 0 ) {
-                            cc.release();
-                            if( !ok ) { 
-                                /* we were already at the end. normal. */
-                            }
-                            else {
-                                uasserted(12585, "cursor gone during bg index; dropDups");
-                            }
-                            break;
+                    BSONObjSetDefaultOrder keys;
+                    idx.getKeysFromObject(js, keys);
+                    int k = 0;
+                    for ( BSONObjSetDefaultOrder::iterator i=keys.begin(); i != keys.end(); i++ ) {
+                        if( ++k == 2 ) {
+                            d->setIndexIsMultikey(idxNo);
                         }
-                    } else {
+                        batch.push_back( make_pair( *i , loc ) );
+                        batchBytes += i->objsize();
+                    }
+                } catch( AssertionException& e ) { 
+                    if( e.interrupted() || !dropDups ) {
                         log() << "background addExistingToIndex exception " << e.what() << endl;
                         throw;
                     }
+                    dups.insert( loc );
                 }
+                bool more = cc->advance();
                 n++;
                 progress.hit();
 
-                if ( n % 128 == 0 && !cc->yield() ) {
+                if ( more && ++batchDocs < BatchDocs && batchBytes < BatchBytes )
+                    continue;
+
+                /* the batch has to be in the index before we yield: a record deleted while we are
+                   yielded would otherwise leave a key behind.  writes that happen while yielded go
+                   through the regular index maintenance, as our index is counted by nIndexesBeingBuilt(). */
+                insertBatch(d, idx, idxNo, batch, dups);
+                batchDocs = 0;
+                batchBytes = 0;
+
+                if ( !dups.empty() ) {
+                    cc->updateLocation();
+                    theDataFileMgr.deleteRecords( ns, vector<DiskLoc>( dups.begin() , dups.end() ) , true );
+                    dups.clear();
+                    if( ClientCursor::find(id, false) == 0 ) {
+                        cc.release();
+                        if( !more ) { 
+                            /* we were already at the end. normal. */
+                        }
+                        else {
+                            uasserted(12585, "cursor gone during bg index; dropDups");
+                        }
+                        break;
+                    }
+                }
+
+                if ( more && !cc->yield() ) {
                     cc.release();
                     uasserted(12584, "cursor gone during bg index");
                     break;
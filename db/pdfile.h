@@ -138,6 +138,9 @@ namespace mongo {
 
         void deleteRecord(const char *ns, Record *todelete, const DiskLoc& dl, bool cappedOK = false, bool noWarn = false);
 
+        /** same as deleteRecord() for each of locs, but index entries are removed in key order, one index at a time */
+        void deleteRecords(const char *ns, const vector<DiskLoc>& locs, bool noWarn = false);
+
         /* does not clean up indexes, etc. : just deletes the record in the pdfile. use deleteRecord() to unindex */
         void _deleteRecord(NamespaceDetails *d, const char *ns, Record *todelete, const DiskLoc& dl);
 
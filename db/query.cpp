@@ -260,7 +260,7 @@ namespace mongo {
 
     /* empty result for error conditions */
     QueryResult* emptyMoreResult(long long cursorid) {
-        BufBuilder b(32768);
+        BufBuilder b(32768, &bufferPool);
         b.skip(sizeof(QueryResult));
         QueryResult *qr = (QueryResult *) b.buf();
         qr->cursorId = 0; // 0 indicates no more data to retrieve.
@@ -283,7 +283,7 @@ namespace mongo {
             bufSize += MaxBytesToReturnToClientAtOnce;
         }
 
-        BufBuilder b( bufSize );
+        BufBuilder b( bufSize, &bufferPool );
 
         b.skip(sizeof(QueryResult));
         
@@ -297,11 +297,13 @@ namespace mongo {
             resultFlags = ResultFlag_CursorNotFound;
         }
         else {
-            if ( pass == 0 )
-                cc->updateSlaveLocation( curop );
-
             int queryOptions = cc->queryOptions();
 
+            /* the getMores of an exhaust cursor are made up by connThread as soon as a batch is sent, so 
+               they say nothing about how far the reader has got */
+            if ( pass == 0 && ! ( queryOptions & QueryOption_Exhaust ) )
+                cc->updateSlaveLocation( curop );
+
             if( pass == 0 ) {
                 StringBuilder& ss = curop.debug().str;
                 ss << " getMore: " << cc->query().toString() << " ";
@@ -608,7 +610,7 @@ namespace mongo {
     public:
         
         UserQueryOp( const ParsedQuery& pq, Message &response, ExplainBuilder &eb, CurOp &curop ) :
-            _buf( 32768 ) , // TODO be smarter here
+            _buf( 32768 , &bufferPool ) , // TODO be smarter here
             _pq( pq ) ,
             _ntoskip( pq.getSkip() ) ,
             _nscanned(0), _oldNscanned(0), _nscannedObjects(0), _oldNscannedObjects(0),
@@ -827,7 +829,7 @@ namespace mongo {
             } 
             else {
                 if ( _buf.len() ) {
-                    _response.appendData( _buf.buf(), _buf.len() );
+                    _response.appendData( _buf.buf(), _buf.len(), true );
                     _buf.decouple();
                 }
             }
@@ -846,7 +848,7 @@ namespace mongo {
             fillQueryResultFromObj(_buf, 0, obj);
             _n = 1;
             _oldN = 0;
-            _response.appendData( _buf.buf(), _buf.len() );
+            _response.appendData( _buf.buf(), _buf.len(), true );
             _buf.decouple();
         }
         
@@ -942,15 +944,14 @@ namespace mongo {
         curop.setQuery(jsobj);
         
         if ( pq.couldBeCommand() ) {
-            BufBuilder bb;
+            BufBuilder bb( 512 , &bufferPool );
             bb.skip(sizeof(QueryResult));
             BSONObjBuilder cmdResBuf;
             if ( runCommands(ns, jsobj, curop, bb, cmdResBuf, false, queryOptions) ) {
                 ss << " command: ";
                 jsobj.toString( ss );
                 curop.markCommand();
-                auto_ptr< QueryResult > qr;
-                qr.reset( (QueryResult *) bb.buf() );
+                QueryResult *qr = (QueryResult *) bb.buf();
                 bb.decouple();
                 qr->setResultFlagsToOk();
                 qr->len = bb.len();
@@ -959,7 +960,7 @@ namespace mongo {
                 qr->cursorId = 0;
                 qr->startingFrom = 0;
                 qr->nReturned = 1;
-                result.setData( qr.release(), true );
+                result.setData( qr, true, true );
             }
             else { 
                 uasserted(10000, "bad or malformed command request?");
@@ -1036,7 +1037,7 @@ namespace mongo {
             Client& c = cc();
             bool found = Helpers::findById( c, ns , query , resObject , &nsFound , &indexFound );
             if ( nsFound == false || indexFound == true ){
-                BufBuilder bb(sizeof(QueryResult)+resObject.objsize()+32);
+                BufBuilder bb(sizeof(QueryResult)+resObject.objsize()+32, &bufferPool);
                 bb.skip(sizeof(QueryResult));
                 
                 ss << " idhack ";
@@ -1044,8 +1045,7 @@ namespace mongo {
                     n = 1;
                     fillQueryResultFromObj( bb , pq.getFields() , resObject );
                 }
-                auto_ptr< QueryResult > qr;
-                qr.reset( (QueryResult *) bb.buf() );
+                QueryResult *qr = (QueryResult *) bb.buf();
                 bb.decouple();
                 qr->setResultFlagsToOk();
                 qr->len = bb.len();
@@ -1054,7 +1054,7 @@ namespace mongo {
                 qr->cursorId = 0;
                 qr->startingFrom = 0;
                 qr->nReturned = n;      
-                result.setData( qr.release(), true );
+                result.setData( qr, true, true );
                 return false;
             }     
         }
@@ -178,7 +178,10 @@ namespace mongo {
 
         if ( ( _scanAndOrderRequired || _order.isEmpty() ) &&
             !fbs.range( idxKey.firstElement().fieldName() ).nontrivial() ) {
-            _unhelpful = true;
+            // a full scan of an index that only holds documents with the field
+            // (e.g. sparse) still answers { $exists : true }
+            if ( !( fbs.nExistsRanges() && _index->getSpec().suitability( fbs.simplifiedQuery() , order ) == OPTIMAL ) )
+                _unhelpful = true;
         }
     }
     
@@ -393,6 +396,7 @@ namespace mongo {
             BSONObj bestIndex = nsd.indexForPattern( _fbs->pattern( _order ) );
             if ( !bestIndex.isEmpty() ) {
                 QueryPlanPtr p;
+                bool unusable = false;
                 _oldNScanned = nsd.nScannedForPattern( _fbs->pattern( _order ) );
                 if ( !strcmp( bestIndex.firstElement().fieldName(), "$natural" ) ) {
                     // Table scan plan
@@ -405,11 +409,15 @@ namespace mongo {
                     IndexDetails& ii = i.next();
                     if( ii.keyPattern().woCompare(bestIndex) == 0 ) {
                         p.reset( new QueryPlan( d, j, *_fbs, *_originalFrs, _originalQuery, _order ) );
+                        // the pattern matches, but the index may still be unable to answer this
+                        // particular query (e.g. a sparse index and a query that matches null)
+                        if ( ii.getSpec().suitability( _fbs->simplifiedQuery() , _order ) == USELESS )
+                            unusable = true;
                     }
                 }
 
                 massert( 10368 ,  "Unable to locate previously recorded index", p.get() );
-                if ( !( _bestGuessOnly && p->scanAndOrderRequired() ) ) {
+                if ( !unusable && !( _bestGuessOnly && p->scanAndOrderRequired() ) ) {
                     _usingPrerecordedPlan = true;
                     _mayRecordPlan = false;
                     _plans.push_back( p );
@@ -428,7 +436,7 @@ namespace mongo {
             return;
 
         // If table scan is optimal or natural order requested or tailable cursor requested
-        if ( !_fbs->matchPossible() || ( _fbs->nNontrivialRanges() == 0 && _order.isEmpty() ) ||
+        if ( !_fbs->matchPossible() || ( _fbs->nNontrivialRanges() == 0 && _fbs->nExistsRanges() == 0 && _order.isEmpty() ) ||
             ( !_order.isEmpty() && !strcmp( _order.firstElement().fieldName(), "$natural" ) ) ) {
             // Table scan plan
             addPlan( QueryPlanPtr( new QueryPlan( d, -1, *_fbs, *_originalFrs, _originalQuery, _order ) ), checkFirst );
@@ -449,7 +457,8 @@ namespace mongo {
             }
 
             QueryPlanPtr p( new QueryPlan( d, i, *_fbs, *_originalFrs, _originalQuery, _order ) );
-            if ( p->optimal() ) {
+            // with only $exists fields every index looks optimal, but only some can answer it
+            if ( p->optimal() && !p->unhelpful() ) {
                 addPlan( p, checkFirst );
                 return;
             } else if ( !p->unhelpful() ) {
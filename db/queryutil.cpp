@@ -128,7 +128,7 @@ namespace mongo {
     }    
     
     
-    FieldRange::FieldRange( const BSONElement &e, bool isNot, bool optimize ) {
+    FieldRange::FieldRange( const BSONElement &e, bool isNot, bool optimize ) : _exists( false ) {
         // NOTE with $not, we could potentially form a complementary set of intervals.
         if ( !isNot && !e.eoo() && e.type() != RegEx && e.getGtLtOp() == BSONObj::opIN ) {
             set< BSONElement, element_lt > vals;
@@ -334,6 +334,10 @@ namespace mongo {
             
             break;
         }
+        case BSONObj::opEXISTS:
+            // bounds stay universal, but an index that skips missing fields can still answer this
+            _exists = ( e.trueValue() != isNot );
+            break;
         case BSONObj::opREGEX:
         case BSONObj::opOPTIONS:
             // do nothing
@@ -346,6 +350,9 @@ namespace mongo {
         case BSONObj::opWITHIN:
             _special = "2d";
             break;
+        case BSONObj::opTEXT:
+            _special = "text";
+            break;
         default:
             break;
         }
@@ -412,6 +419,7 @@ namespace mongo {
             }
         }
         finishOperation( newIntervals, other );
+        _exists = _exists || other._exists;
         return *this;
     }
     
@@ -461,6 +469,7 @@ namespace mongo {
         tmp._upper = high;
         newIntervals.push_back( tmp );        
         finishOperation( newIntervals, other );
+        _exists = _exists && other._exists;
         return *this;        
     }
     
@@ -703,6 +712,8 @@ namespace mongo {
                 o = c.obj();
                 b.append( name, o );
             }
+            else if ( range.exists() )
+                b.append( name, BSON( "$exists" << true ) );
         }
         return b.obj();
     }
@@ -722,6 +733,8 @@ namespace mongo {
                     qp._fieldTypes[ i->first ] = QueryPattern::UpperBound;
                 else if ( lower )
                     qp._fieldTypes[ i->first ] = QueryPattern::LowerBound;                    
+            } else if ( i->second.exists() ) {
+                qp._fieldTypes[ i->first ] = QueryPattern::Exists;
             }
         }
         qp.setSort( sort );
@@ -93,6 +93,8 @@ namespace mongo {
         }
         bool empty() const { return _intervals.empty(); }
         void makeEmpty() { _intervals.clear(); }
+        // true iff the field must be present, from { $exists : true } - the range itself stays trivial
+        bool exists() const { return _exists; }
 		const vector< FieldInterval > &intervals() const { return _intervals; }
         string getSpecial() const { return _special; }
         void setExclusiveBounds() {
@@ -107,6 +109,7 @@ namespace mongo {
             assert( _special.empty() );
             ret._intervals.clear();
             ret._objData = _objData;
+            ret._exists = _exists;
             for( vector< FieldInterval >::const_reverse_iterator i = _intervals.rbegin(); i != _intervals.rend(); ++i ) {
                 FieldInterval fi;
                 fi._lower = i->_upper;
@@ -120,6 +123,7 @@ namespace mongo {
         vector< FieldInterval > _intervals;
         vector< BSONObj > _objData;
         string _special;
+        bool _exists;
     };
     
     // implements query pattern matching, used to determine if a query is
@@ -131,7 +135,8 @@ namespace mongo {
             Equality,
             LowerBound,
             UpperBound,
-            UpperAndLowerBound
+            UpperAndLowerBound,
+            Exists
         };
         // for testing only, speed unimportant
         bool operator==( const QueryPattern &other ) const {
@@ -225,6 +230,15 @@ namespace mongo {
             }
             return count;
         }
+        // number of fields only constrained by { $exists : true }
+        int nExistsRanges() const {
+            int count = 0;
+            for( map< string, FieldRange >::const_iterator i = _ranges.begin(); i != _ranges.end(); ++i ) {
+                if ( i->second.exists() && !i->second.nontrivial() )
+                    ++count;
+            }
+            return count;
+        }
         const char *ns() const { return _ns; }
         // if fields is specified, order fields of returned object to match those of 'fields'
         BSONObj simplifiedQuery( const BSONObj &fields = BSONObj() ) const;
@@ -379,6 +379,11 @@ namespace mongo {
             appendReplicationInfo( result , authed );
 
             result.appendNumber("maxBsonObjectSize", BSONObjMaxUserSize);
+            if ( compressionSupported() )
+                result.append("compression", BSON_ARRAY( "zlib" ) );
+            string sock = makeUnixSockPath( cmdLine.port );
+            if ( ListeningSockets::get()->hasPath( sock ) )
+                result.append("unixSocket", sock);
             return true;
         }
     } cmdismaster;
@@ -1454,6 +1459,10 @@ namespace mongo {
         
         BSONObjBuilder cmd;
         cmd.appendAs( me["_id"] , "handshake" );
+        if ( theReplSet ) {
+            // we send replSetUpdatePosition after applying, don't count how far we have read
+            cmd.appendBool( "reportsApplied" , true );
+        }
 
         BSONObj res;
         bool ok = conn->runCommand( "admin" , cmd.obj() , res );
@@ -1463,7 +1472,8 @@ namespace mongo {
     }
 
     bool OplogReader::connect(string hostName) {
-        if( conn() == 0 ) {
+        if( _conn.get() == 0 ) {
+            _host = hostName;
             _conn = auto_ptr<DBClientConnection>(new DBClientConnection( false, 0, replPair ? 20 : 0 /* tcp timeout */));
             string errmsg;
             ReplInfo r("trying to connect to sync source");
@@ -73,6 +73,10 @@ namespace mongo {
     bool cloneFrom(const char *masterHost, string& errmsg, const string& fromdb, bool logForReplication, 
 				   bool slaveOk, bool useReplAuth, bool snapshot);
 
+    /* clone dbs from host in parallel for an initial sync, see cloner.cpp.  call with no lock held. */
+    bool cloneDatabases( const string& host , const list<string>& dbs , int nConnections , 
+                         boost::function<void(const string&)> progress , string& errmsg );
+
     /* A replication exception */
     class SyncException : public DBException {
     public:
@@ -109,6 +109,10 @@ namespace mongo {
             s << td( grey(str::stream() << hbinfo().skew,!ok) );
         } else
             s << td("");
+        if( hbinfo().ping >= 0 ) {
+            s << td( grey(str::stream() << hbinfo().ping,!ok) );
+        } else
+            s << td("");
         s << _tr();
     }
    
@@ -271,6 +275,11 @@ namespace mongo {
         s << table(0, false);
         s << tr("Set name:", _name);
         s << tr("Majority up:", elect.aMajoritySeemsToBeUp()?"yes":"no" );
+        {
+            string t = syncSourceFeedback.target();
+            if( !t.empty() )
+                s << tr("Syncing from:", t);
+        }
         s << _table();
 
         const char *h[] = {"Member", 
@@ -281,6 +290,7 @@ namespace mongo {
             "Votes", "Priority", "State", "Messages", 
             "<a title=\"how up to date this server is.  this value polled every few seconds so actually lag is typically much lower than value shown here.\">optime</a>", 
             "<a title=\"Clock skew in seconds relative to this server. Informational; server clock variances will make the diagnostics hard to read, but otherwise are benign..\">skew</a>", 
+            "<a title=\"Heartbeat round trip time in milliseconds, averaged.  Secondaries sync from a closer secondary instead of the primary if there is one.\">ping</a>", 
             0};
         s << table(h);
 
@@ -319,6 +329,7 @@ namespace mongo {
             q << "/_replSetOplog?_id=" << _self->id();
             s << td( a(q.str(), myMinValid, theReplSet->lastOpTimeWritten.toString()) );
             s << td(""); // skew
+            s << td(""); // ping
             s << _tr();
 			mp[_self->hbinfo().id()] = s.str();
         }
@@ -333,6 +344,9 @@ namespace mongo {
         for( map<int,string>::const_iterator i = mp.begin(); i != mp.end(); i++ )
             s << i->second;
         s << _table();
+
+        s << p("Oplog application on this member, by " + ToString((int) ReplStatsHistory::IntervalSecs) + " second periods:");
+        statsHistory.outputHTML(s, 15);
     }
 
 
@@ -388,6 +402,8 @@ namespace mongo {
             bb.appendTimestamp("optime", m->hbinfo().opTime.asDate());
             bb.appendDate("optimeDate", m->hbinfo().opTime.getSecs() * 1000LL);
             bb.appendTimeT("lastHeartbeat", m->hbinfo().lastHeartbeat);
+            if( m->hbinfo().ping >= 0 )
+                bb.append("pingMs", m->hbinfo().ping);
             string s = m->lhb();
             if( !s.empty() )
                 bb.append("errmsg", s);
@@ -398,7 +414,22 @@ namespace mongo {
         b.append("set", name());
         b.appendTimeT("date", time(0));
         b.append("myState", box.getState().s);
+        {
+            string t = syncSourceFeedback.target();
+            if( !t.empty() )
+                b.append("syncingTo", t);
+        }
         b.append("members", v);
+        {
+            BSONObjBuilder bb(b.subobjStart("apply"));
+            _applyStats.append(bb);
+            bb.done();
+        }
+        {
+            BSONObjBuilder bb(b.subobjStart("fetch"));
+            _buffer.append(bb);
+            bb.done();
+        }
         if( replSetBlind )
             b.append("blind",true); // to avoid confusion if set...normally never set except for testing.
     }
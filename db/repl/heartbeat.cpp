@@ -158,6 +158,7 @@ namespace mongo {
                 int theirConfigVersion = -10000;
 
                 time_t before = time(0);
+                Timer timer;
 
                 bool ok = requestHeartbeat(theReplSet->name(), theReplSet->selfFullName(), h.toString(), info, theReplSet->config().version, theirConfigVersion);
 
@@ -188,6 +189,11 @@ namespace mongo {
                         mem.upSince = mem.lastHeartbeat;
                     }
                     mem.health = 1.0;
+                    {
+                        /* averaged so one slow round trip doesn't make us change sync source, see getSyncSource() */
+                        int t = timer.millis();
+                        mem.ping = mem.ping < 0 ? t : (mem.ping * 3 + t) / 4;
+                    }
                     mem.lastHeartbeatMsg = info["hbmsg"].String();
                     if( info.hasElement("opTime") )
                         mem.opTime = info["opTime"].Date();
@@ -274,6 +280,10 @@ namespace mongo {
         mgr->send( boost::bind(&Manager::msgCheckNewState, theReplSet->mgr) );
 
         boost::thread t(startSyncThread);
+
+        boost::thread f(boost::bind(&SyncSourceFeedback::run, &syncSourceFeedback));
+
+        boost::thread s(boost::bind(&ReplSetImpl::statsThread, this));
     }
 
 }
@@ -17,12 +17,14 @@
 #include "pch.h"
 #include "../cmdline.h"
 #include "../commands.h"
+#include "../client.h"
 #include "health.h"
 #include "rs.h"
 #include "rs_config.h"
 #include "../dbwebserver.h"
 #include "../../util/mongoutils/html.h"
 #include "../../client/dbclient.h"
+#include "../repl_block.h"
 
 namespace mongo { 
 
@@ -79,6 +81,57 @@ namespace mongo {
         }
     } cmdReplSetRBID;
 
+    /* { replSetUpdatePosition : 1 , positions : [ { rid : <rid> , host : <host> , optime : <ts> } ... ] }
+       sent by a member to its sync source with how far it and the members syncing from it have applied.  see SyncSourceFeedback */
+    class CmdReplSetUpdatePosition : public ReplSetCommand {
+    public:
+        CmdReplSetUpdatePosition() : ReplSetCommand("replSetUpdatePosition") { }
+        virtual bool run(const string& , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            if( !check(errmsg, result) ) 
+                return false;
+            if( cmdObj["positions"].type() != Array ) { 
+                errmsg = "positions has to be an array";
+                return false;
+            }
+            /* local.slaves is looked up the first time we hear of a member */
+            readlock lk("local.slaves");
+            Client::Context ctx("local.slaves");
+            BSONObjIterator i(cmdObj["positions"].embeddedObject());
+            while( i.more() ) { 
+                BSONObj p = i.next().Obj();
+                updateSlaveLocation(p["rid"].Obj(), p["host"].String(), rsoplog, p["optime"]._opTime());
+            }
+            return true;
+        }
+    } cmdReplSetUpdatePosition;
+
+    /* { replSetGetApplyStats : 1 , n : <intervals> }
+       how oplog fetching and application went on this member over the last few minutes.  see ReplStatsHistory */
+    class CmdReplSetGetApplyStats : public ReplSetCommand {
+    public:
+        virtual void help( stringstream &help ) const {
+            help << "oplog apply rate, batch sizes, latencies by op type, bytes received and lag on this member, newest first\n";
+            help << "{ replSetGetApplyStats : 1 , n : <number of intervals, default 15> }";
+        }
+        CmdReplSetGetApplyStats() : ReplSetCommand("replSetGetApplyStats") { }
+        virtual bool run(const string& , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            if( !check(errmsg, result) ) 
+                return false;
+            int n = cmdObj["n"].isNumber() ? cmdObj["n"].numberInt() : 15;
+            result.append("intervalSecs", (int) ReplStatsHistory::IntervalSecs);
+            {
+                BSONArrayBuilder a(result.subarrayStart("latencyBucketsMicros"));
+                for( int k = 0; k < ApplyCounters::LatencyBuckets - 1; k++ )
+                    a.append(ApplyCounters::latencyBucketLimit(k));
+                a.done();
+            }
+            BSONArrayBuilder a(result.subarrayStart("intervals"));
+            theReplSet->statsHistory.appendIntervals(a, n);
+            a.done();
+            return true;
+        }
+    } cmdReplSetGetApplyStats;
+
     using namespace bson;
     void incRBID() { 
         cmdReplSetRBID.rbid++;
@@ -205,6 +258,34 @@ namespace mongo {
         }
     } cmdReplSetFreeze;
 
+    class CmdReplSetSyncFrom : public ReplSetCommand {
+    public:
+        virtual void help( stringstream &help ) const {
+            help << "{ replSetSyncFrom : \"host:port\" }\n";
+            help << "Sync from the given member rather than the one picked by ping time, while it is up and\n";
+            help << "not behind this member.  {replSetSyncFrom:\"\"} goes back to picking one.";
+        }
+
+        CmdReplSetSyncFrom() : ReplSetCommand("replSetSyncFrom") { }
+        virtual bool run(const string& , BSONObj& cmdObj, string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            if( !check(errmsg, result) )
+                return false;
+            if( cmdObj.firstElement().type() != String ) { 
+                errmsg = "replSetSyncFrom takes a host:port string";
+                return false;
+            }
+            if( theReplSet->isPrimary() ) { 
+                errmsg = "primary does not sync";
+                return false;
+            }
+            string prev = theReplSet->syncSourceFeedback.target();
+            if( !theReplSet->syncFrom(cmdObj.firstElement().String(), errmsg) )
+                return false;
+            result.append("prevSyncTarget", prev);
+            return true;
+        }
+    } cmdReplSetSyncFrom;
+
     class CmdReplSetStepDown: public ReplSetCommand {
     public:
         virtual void help( stringstream &help ) const {
@@ -22,6 +22,7 @@
 #include "../../util/concurrency/value.h"
 #include "../../util/concurrency/msg.h"
 #include "../../util/hostandport.h"
+#include "../../util/concurrency/thread_pool.h"
 #include "../commands.h"
 #include "rs_exception.h"
 #include "rs_optime.h"
@@ -232,6 +233,146 @@ namespace mongo {
         set<HostAndPort> seedSet;
     };
 
+    /* running totals of oplog application on a secondary.  ApplyStats keeps them, ReplStatsHistory keeps 
+       copies from every few seconds.  see syncApplyBatch() */
+    struct ApplyCounters { 
+        enum { OpTypes = 5 };        // insert, update, delete, command, other (no-ops)
+        enum { LatencyBuckets = 7 }; // < 10us, < 100us, < 1ms, < 10ms, < 100ms, < 1s, more
+        ApplyCounters();
+        void gotOp(const BSONObj& op, long long micros);
+        void add(const ApplyCounters& c);
+        void subtract(const ApplyCounters& c);
+        static const char* opTypeName(int t);
+        static long long latencyBucketLimit(int b); // micros, -1 for the last one
+
+        long long batches;        // write lock acquisitions
+        long long ops;
+        long long micros;         // applying, in the write lock
+        long long lockWaitMicros; // waiting for the write lock
+        long long opCount[OpTypes];
+        long long opMicros[OpTypes];
+        long long opLatency[OpTypes][LatencyBuckets];
+    };
+
+    /* how oplog application on a secondary is going, for replSetGetStatus.  see syncTail() */
+    class ApplyStats { 
+    public:
+        ApplyStats();
+        /* the ops applied in one write lock acquisition */
+        void gotBatch(const ApplyCounters& batch);
+        ApplyCounters counters() const;
+        void append(BSONObjBuilder& b) const;
+    private:
+        mutable mongo::mutex _m;
+        ApplyCounters _c;
+        int _lastBatch;
+        int _maxBatch;
+    };
+
+    /* running totals of oplog fetching, see OplogBuffer */
+    struct FetchCounters { 
+        FetchCounters() : fetches(0), micros(0), bytes(0) { }
+        long long fetches; // batches read from the sync source that had ops
+        long long micros;  // waiting for those batches
+        long long bytes;   // of ops received
+    };
+
+    /* oplog entries read from the sync source that are waiting to be applied, and how fetching them is 
+       going.  holds at most MaxBytes worth, push() waits for room when it is full.  see syncTail() 
+    */
+    class OplogBuffer : boost::noncopyable { 
+    public:
+        static const int MaxBytes = 64 * 1024 * 1024;
+        OplogBuffer();
+        void reset();
+
+        /* fetcher side.  @return false if stopped */
+        bool push(const BSONObj& o);
+        void finish(); // no more coming
+        void gotFetch(long long micros); // a batch read from the sync source that had ops
+        FetchCounters counters() const;
+
+        /* applier side.  waits up to millis for ops, then takes up to max of them. @return false if none */
+        bool pop(vector<BSONObj>& v, unsigned max, int millis);
+        bool finished() const; // and empty
+        void stop(); // makes push() return false
+
+        bool stopped() const;
+        void append(BSONObjBuilder& b) const;
+    private:
+        mutable mongo::mutex _m;
+        boost::condition _notEmpty;
+        boost::condition _notFull;
+        deque<BSONObj> _q;
+        long long _bytes;
+        bool _finished;
+        bool _stopped;
+        FetchCounters _c;
+        long long _lastFetchMicros;
+        long long _fullWaits; // times the fetcher waited for the applier
+    };
+
+    /* the member we sync from, and the positions to send it: our own after each batch we apply, and those 
+       of members that sync from us, passed on until they reach the primary.  so getLastError w goes by 
+       what members applied rather than what they read, and counts members that chain off a secondary.  
+       see rs_sync.cpp
+    */
+    class SyncSourceFeedback : boost::noncopyable { 
+    public:
+        SyncSourceFeedback();
+        void setTarget(const string& hostport); // empty if we aren't syncing
+        string target() const;
+
+        /* a member applied ops up to ot.  rid and host as in local.slaves */
+        void gotPosition(const BSONObj& rid, const string& host, OpTime ot);
+
+        void run(); // thread, sends the positions to the target
+    private:
+        struct Position { 
+            BSONObj rid;
+            string host;
+            OpTime ot;
+        };
+        mutable mongo::mutex _m;
+        boost::condition _changed;
+        string _target;
+        vector<Position> _pending; // latest per member, not yet sent
+    };
+
+    /* apply and fetch totals at a point in time, see ReplStatsHistory */
+    struct ReplStatsSnapshot { 
+        ReplStatsSnapshot() : created(0), pageFaults(-1) { }
+        unsigned long long created; // curTimeMicros64()
+        ApplyCounters apply;
+        FetchCounters fetch;
+        OpTime applied;             // our last op
+        OpTime primary;             // the primary's last op, by heartbeat.  null if there is no primary
+        long long pageFaults;       // whole process, -1 if not known on this platform
+    };
+
+    /* the last n snapshots of a member's apply and fetch counters, taken every IntervalSecs, so its ops 
+       per second, batch sizes, latencies by op type, bytes received and lag can be looked at over the 
+       last few minutes.  like Snapshots in db/stats/snapshots.h.  see replSetGetApplyStats and /_replSet
+    */
+    class ReplStatsHistory : boost::noncopyable { 
+    public:
+        enum { IntervalSecs = 4 };
+        ReplStatsHistory(int n = 100);
+        void take(const ReplStatsSnapshot& s);
+
+        /* the intervals between snapshots, newest first, at most max of them */
+        void appendIntervals(BSONArrayBuilder& a, int max) const;
+        void outputHTML(stringstream& ss, int max) const;
+    private:
+        const ReplStatsSnapshot& getPrev(int numBack) const;
+        int numDeltas() const { return _stored - 1; }
+        mutable mongo::mutex _m;
+        int _n;
+        boost::scoped_array<ReplStatsSnapshot> _snapshots;
+        int _loc;
+        int _stored;
+    };
+
     /* information about the entire repl set, such as the various servers in the set, and their state */
     /* note: We currently do not free mem when the set goes away - it is assumed the replset is a 
              singleton and long lived.
@@ -265,6 +406,7 @@ namespace mongo {
     protected:
         bool _stepDown(int secs);
         bool _freeze(int secs);
+        bool _syncFrom(const string& host, string& errmsg);
     private:
         void assumePrimary();
         void loadLastOpTimeWritten();
@@ -344,7 +486,25 @@ namespace mongo {
         void _syncThread();
         bool tryToGoLiveAsASecondary(OpTime&); // readlocks
         void syncTail();
+        bool syncApplyBatch(const vector<BSONObj>& ops, const Member *primary);
         void syncApply(const BSONObj &o);
+        void syncFetch(OplogReader *r, string *err);
+        const Member* getSyncSource(const Member *primary);
+        bool shouldChangeSyncSource(const Member *source, const Member *primary, time_t& lastCheck);
+        void vetoSyncSource(const Member *m, int secs);
+        bool vetoed(const Member *m);
+        map<string,time_t> _syncSourceVetoes; // fullName -> until when.  sync thread only
+        string _forcedSyncSource; // fullName from replSetSyncFrom, empty if none.  under the RSBase lock
+        string forcedSyncSource() { lock lk(this); return _forcedSyncSource; }
+        void syncPretouch(const shared_ptr< vector<BSONObj> >& ops);
+        ApplyStats _applyStats;
+        OplogBuffer _buffer;
+        auto_ptr<ThreadPool> _pretouchPool; // --pretouch, see syncPretouch()
+        void statsThread(); // see rs_stats.cpp
+    public:
+        SyncSourceFeedback syncSourceFeedback;
+        ReplStatsHistory statsHistory;
+    private:
         unsigned _syncRollback(OplogReader& r);
         void syncRollback(OplogReader& r);
         void syncFixUp(HowToFixUp& h, OplogReader& r);
@@ -362,6 +522,9 @@ namespace mongo {
         // for the replSetFreeze command
         bool freeze(int secs) { return _freeze(secs); }
 
+        // for the replSetSyncFrom command
+        bool syncFrom(const string& host, string& errmsg) { return _syncFrom(host, errmsg); }
+
         string selfFullName() { 
             lock lk(this);
             return _self->fullName();
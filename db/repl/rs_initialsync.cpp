@@ -57,15 +57,8 @@ namespace mongo {
         }
     }
 
-    bool cloneFrom(const char *masterHost, string& errmsg, const string& fromdb, bool logForReplication, 
-				   bool slaveOk, bool useReplAuth, bool snapshot);
-
-    /* todo : progress metering to sethbmsg. */
-    static bool clone(const char *master, string db) {
-        string err;
-        return cloneFrom(master, err, db, false,
-            /* slave_ok */ true, true, false);
-    }
+    /* connections to the sync source used to clone the databases, see cloneDatabases() */
+    const int InitialSyncConnections = 4;
 
     void _logOpObjRS(const BSONObj& op);
 
@@ -178,23 +171,18 @@ namespace mongo {
 
             sethbmsg("initial sync clone all databases", 0);
 
-            list<string> dbs = r.conn()->getDatabaseNames();
-            for( list<string>::iterator i = dbs.begin(); i != dbs.end(); i++ ) {
-                string db = *i;
-                if( db != "local" ) {
-                    sethbmsg( str::stream() << "initial sync cloning db: " << db , 0);
-                    bool ok;
-                    {
-                        writelock lk(db);
-                        Client::Context ctx(db);
-                        ok = clone(sourceHostname.c_str(), db);
-                    }
-                    if( !ok ) { 
-                        sethbmsg( str::stream() << "initial sync error clone of " << db << " failed sleeping 5 minutes" ,0);
-                        sleepsecs(300);
-                        return;
-                    }
-                }
+            list<string> all = r.conn()->getDatabaseNames();
+            list<string> dbs;
+            for( list<string>::iterator i = all.begin(); i != all.end(); i++ ) {
+                if( *i != "local" )
+                    dbs.push_back(*i);
+            }
+            string err;
+            if( !cloneDatabases(sourceHostname, dbs, InitialSyncConnections, 
+                                boost::bind(&ReplSetImpl::sethbmsg, this, _1, 0), err) ) { 
+                sethbmsg( str::stream() << "initial sync error clone failed: " << err << " sleeping 5 minutes" ,0);
+                sleepsecs(300);
+                return;
             }
         }
 
@@ -65,7 +65,7 @@ namespace mongo {
     class HeartbeatInfo { 
         unsigned _id;
     public:
-        HeartbeatInfo() : _id(0xffffffff),hbstate(MemberState::RS_UNKNOWN),health(-1.0),downSince(0),skew(INT_MIN) { }
+        HeartbeatInfo() : _id(0xffffffff),hbstate(MemberState::RS_UNKNOWN),health(-1.0),downSince(0),skew(INT_MIN),ping(-1) { }
         HeartbeatInfo(unsigned id);
         bool up() const { return health > 0; }
         unsigned id() const { return _id; }
@@ -77,6 +77,7 @@ namespace mongo {
         string lastHeartbeatMsg;
         OpTime opTime;
         int skew;
+        int ping; // ms, moving average of heartbeat round trips.  -1 if we haven't heard back yet
 
         long long timeDown() const; // ms
 
@@ -90,6 +91,7 @@ namespace mongo {
         downSince = 0;
         lastHeartbeat = upSince = 0; 
         skew = INT_MIN;
+        ping = -1;
     }
 
     inline bool HeartbeatInfo::changed(const HeartbeatInfo& old) const { 
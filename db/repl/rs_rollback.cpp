@@ -315,6 +315,41 @@ namespace mongo {
        }
     }
 
+    /* most documents syncFixUp() refetches with one query, and how big their _id's can be in total */
+    static const unsigned RefetchBatchIds = 1000;
+    static const int RefetchBatchBytes = 1024 * 1024;
+
+    /* refetch the documents [b, e) of toRefetch, which are all in one collection, with one $in query instead of 
+       a round trip each.  the ones that aren't there anymore come back empty, to be deleted. */
+    static void refetchBatch(DBClientConnection *them, set<DocID>::iterator b, set<DocID>::iterator e, 
+                             list< pair<DocID,bo> >& goodVersions, unsigned long long& totSize) {
+        bob q;
+        {
+            bob id(q.subobjStart("_id"));
+            BSONArrayBuilder in(id.subarrayStart("$in"));
+            for( set<DocID>::iterator i = b; i != e; i++ )
+                in.append(i->_id);
+            in.done();
+            id.done();
+        }
+
+        map<be,bo> found; // by _id, the elements point into the found objects
+        auto_ptr<DBClientCursor> c = them->query(b->ns, q.obj());
+        uassert( 13546, str::stream() << "rollback refetch query failed " << b->ns, c.get() );
+        while( c->more() ) {
+            bo good = c->nextSafe().getOwned();
+            totSize += good.objsize();
+            uassert( 13554, "replSet too much data to roll back", totSize < 300 * 1024 * 1024 );
+            found[good["_id"]] = good;
+        }
+
+        /* toRefetch is in ns, _id order, so goodVersions is too */
+        for( set<DocID>::iterator i = b; i != e; i++ ) {
+            map<be,bo>::iterator f = found.find(i->_id);
+            goodVersions.push_back(pair<DocID,bo>(*i, f == found.end() ? bo() : f->second));
+        }
+    }
+
     void ReplSetImpl::syncFixUp(HowToFixUp& h, OplogReader& r) {
        DBClientConnection *them = r.conn();
 
@@ -330,13 +365,30 @@ namespace mongo {
        DocID d;
        unsigned long long n = 0;
        try {
-           for( set<DocID>::iterator i = h.toRefetch.begin(); i != h.toRefetch.end(); i++ ) { 
+           set<DocID>::iterator i = h.toRefetch.begin();
+           while( i != h.toRefetch.end() ) { 
                d = *i;
 
                assert( !d._id.eoo() );
 
-               {
-                   /* TODO : slow.  lots of round trips. */
+               /* as many as we can get in one query: same collection, and not a regex _id, which $in 
+                  would take as a pattern */
+               set<DocID>::iterator e = i;
+               unsigned ids = 0;
+               int bytes = 0;
+               while( e != h.toRefetch.end() && strcmp(e->ns, d.ns) == 0 && e->_id.type() != RegEx && 
+                      ids < RefetchBatchIds && bytes < RefetchBatchBytes ) {
+                   bytes += e->_id.size();
+                   ids++;
+                   e++;
+               }
+
+               if( ids ) { 
+                   refetchBatch(them, i, e, goodVersions, totSize);
+                   n += ids;
+                   i = e;
+               }
+               else {
                    n++;
                    bo good= them->findOne(d.ns, d._id.wrap()).getOwned();
                    totSize += good.objsize();
@@ -344,6 +396,7 @@ namespace mongo {
 
                    // note good might be eoo, indicating we should delete it
                    goodVersions.push_back(pair<DocID,bo>(d,good));
+                   i++;
                }
            }
            newMinValid = r.getLastOp(rsoplog);
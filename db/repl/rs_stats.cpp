@@ -0,0 +1,269 @@
+/* @file rs_stats.cpp  time series of how oplog fetching and application are going on a member */
+
+/**
+*    Copyright (C) 2008 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pch.h"
+#include "rs.h"
+#include "../../util/processinfo.h"
+#include "../../util/mongoutils/html.h"
+
+namespace mongo {
+
+    using namespace mongoutils::html;
+
+    ApplyCounters::ApplyCounters() : batches(0), ops(0), micros(0), lockWaitMicros(0) {
+        memset(opCount, 0, sizeof(opCount));
+        memset(opMicros, 0, sizeof(opMicros));
+        memset(opLatency, 0, sizeof(opLatency));
+    }
+
+    static int opType(const BSONObj& op) {
+        switch( *op.getStringField("op") ) {
+        case 'i': return 0;
+        case 'u': return 1;
+        case 'd': return 2;
+        case 'c': return 3;
+        }
+        return 4;
+    }
+
+    const char* ApplyCounters::opTypeName(int t) {
+        static const char *names[OpTypes] = { "insert", "update", "delete", "command", "other" };
+        return names[t];
+    }
+
+    long long ApplyCounters::latencyBucketLimit(int b) {
+        if( b == LatencyBuckets - 1 )
+            return -1;
+        long long x = 10;
+        while( b-- > 0 )
+            x *= 10;
+        return x;
+    }
+
+    void ApplyCounters::gotOp(const BSONObj& op, long long micros) {
+        int t = opType(op);
+        int b = 0;
+        while( b < LatencyBuckets - 1 && micros >= latencyBucketLimit(b) )
+            b++;
+        ops++;
+        opCount[t]++;
+        opMicros[t] += micros;
+        opLatency[t][b]++;
+    }
+
+    void ApplyCounters::add(const ApplyCounters& c) {
+        batches += c.batches;
+        ops += c.ops;
+        micros += c.micros;
+        lockWaitMicros += c.lockWaitMicros;
+        for( int t = 0; t < OpTypes; t++ ) {
+            opCount[t] += c.opCount[t];
+            opMicros[t] += c.opMicros[t];
+            for( int b = 0; b < LatencyBuckets; b++ )
+                opLatency[t][b] += c.opLatency[t][b];
+        }
+    }
+
+    void ApplyCounters::subtract(const ApplyCounters& c) {
+        batches -= c.batches;
+        ops -= c.ops;
+        micros -= c.micros;
+        lockWaitMicros -= c.lockWaitMicros;
+        for( int t = 0; t < OpTypes; t++ ) {
+            opCount[t] -= c.opCount[t];
+            opMicros[t] -= c.opMicros[t];
+            for( int b = 0; b < LatencyBuckets; b++ )
+                opLatency[t][b] -= c.opLatency[t][b];
+        }
+    }
+
+    /* what happened between two snapshots */
+    struct ReplStatsDelta {
+        ReplStatsDelta(const ReplStatsSnapshot& older, const ReplStatsSnapshot& newer) :
+            start(older.created), apply(newer.apply), pageFaults(-1), lagSecs(-1)
+        {
+            secs = (newer.created - older.created) / 1000000.0;
+            apply.subtract(older.apply);
+            fetches = newer.fetch.fetches - older.fetch.fetches;
+            fetchMicros = newer.fetch.micros - older.fetch.micros;
+            bytes = newer.fetch.bytes - older.fetch.bytes;
+            if( older.pageFaults >= 0 && newer.pageFaults >= 0 )
+                pageFaults = newer.pageFaults - older.pageFaults;
+            if( !newer.primary.isNull() )
+                lagSecs = max((int) newer.primary.getSecs() - (int) newer.applied.getSecs(), 0);
+        }
+        unsigned long long start;
+        double secs;
+        ApplyCounters apply;
+        long long fetches;
+        long long fetchMicros;
+        long long bytes;
+        long long pageFaults;
+        int lagSecs;
+
+        double opsPerSec() const { return secs > 0 ? apply.ops / secs : 0.0; }
+        double avgBatchSize() const { return apply.batches ? (double) apply.ops / apply.batches : 0.0; }
+        double avgFetchMillis() const { return fetches ? fetchMicros / 1000.0 / fetches : 0.0; }
+        int percentApplying() const { return secs > 0 ? (int) (apply.micros / 10000.0 / secs) : 0; }
+    };
+
+    ReplStatsHistory::ReplStatsHistory(int n) :
+        _m("ReplStatsHistory"), _n(n), _snapshots(new ReplStatsSnapshot[n]), _loc(0), _stored(0)
+    { }
+
+    void ReplStatsHistory::take(const ReplStatsSnapshot& s) {
+        scoped_lock lk(_m);
+        _loc = (_loc + 1) % _n;
+        _snapshots[_loc] = s;
+        if( _stored < _n )
+            _stored++;
+    }
+
+    const ReplStatsSnapshot& ReplStatsHistory::getPrev(int numBack) const {
+        int x = _loc - numBack;
+        if( x < 0 )
+            x += _n;
+        return _snapshots[x];
+    }
+
+    void ReplStatsHistory::appendIntervals(BSONArrayBuilder& a, int max) const {
+        scoped_lock lk(_m);
+        for( int i = 0; i < numDeltas() && i < max; i++ ) {
+            ReplStatsDelta d(getPrev(i+1), getPrev(i));
+            BSONObjBuilder b(a.subobjStart());
+            b.appendDate("start", d.start / 1000);
+            b.append("secs", d.secs);
+            b.appendNumber("ops", d.apply.ops);
+            b.append("opsPerSec", d.opsPerSec());
+            b.appendNumber("batches", d.apply.batches);
+            b.append("avgBatchSize", d.avgBatchSize());
+            b.appendNumber("applyMillis", d.apply.micros / 1000);
+            b.appendNumber("lockWaitMillis", d.apply.lockWaitMicros / 1000);
+            b.appendNumber("fetches", d.fetches);
+            b.append("avgFetchMillis", d.avgFetchMillis());
+            b.appendNumber("bytesReceived", d.bytes);
+            if( d.pageFaults >= 0 )
+                b.appendNumber("pageFaults", d.pageFaults);
+            if( d.lagSecs >= 0 )
+                b.append("lagSecs", d.lagSecs);
+            {
+                BSONObjBuilder types(b.subobjStart("opTypes"));
+                for( int t = 0; t < ApplyCounters::OpTypes; t++ ) {
+                    if( d.apply.opCount[t] == 0 )
+                        continue;
+                    BSONObjBuilder bb(types.subobjStart(ApplyCounters::opTypeName(t)));
+                    bb.appendNumber("n", d.apply.opCount[t]);
+                    bb.append("avgMicros", (double) d.apply.opMicros[t] / d.apply.opCount[t]);
+                    BSONArrayBuilder h(bb.subarrayStart("latency"));
+                    for( int k = 0; k < ApplyCounters::LatencyBuckets; k++ )
+                        h.append(d.apply.opLatency[t][k]);
+                    h.done();
+                    bb.done();
+                }
+                types.done();
+            }
+            b.done();
+        }
+    }
+
+    void ReplStatsHistory::outputHTML(stringstream& ss, int max) const {
+        scoped_lock lk(_m);
+        if( numDeltas() < 1 )
+            return;
+
+        const char *h[] = { "ago", "secs", "ops/sec", "avg batch",
+            "<a title=\"percent of the time applying ops in the write lock\">% applying</a>",
+            "<a title=\"time the applier waited for the write lock\">lock wait ms</a>",
+            "<a title=\"average round trip to the sync source for a batch of ops\">fetch ms</a>",
+            "KB received",
+            "<a title=\"page faults of the whole process\">faults</a>",
+            "<a title=\"seconds behind the primary, by heartbeat\">lag</a>",
+            0 };
+        ss << table(h);
+        unsigned long long now = curTimeMicros64();
+        ss.precision(3);
+        for( int i = 0; i < numDeltas() && i < max; i++ ) {
+            ReplStatsDelta d(getPrev(i+1), getPrev(i));
+            ss << tr() << td((int) ((now - d.start) / 1000000)) << td(d.secs) << td((long long) d.opsPerSec())
+               << td(d.avgBatchSize()) << td(d.percentApplying()) << td(d.apply.lockWaitMicros / 1000)
+               << td(d.avgFetchMillis()) << td(d.bytes / 1024)
+               << td(d.pageFaults >= 0 ? ToString(d.pageFaults) : string(""))
+               << td(d.lagSecs >= 0 ? ToString(d.lagSecs) : string("")) << _tr();
+        }
+        ss << _table();
+
+        /* latencies over all we have */
+        ReplStatsDelta all(getPrev(numDeltas()), getPrev(0));
+        ss << "<table border=1 cellpadding=2 cellspacing=0><tr><th>op</th><th>n</th><th>avg us</th>";
+        for( int k = 0; k < ApplyCounters::LatencyBuckets; k++ ) {
+            long long lim = ApplyCounters::latencyBucketLimit(k);
+            if( lim > 0 )
+                ss << "<th>&lt; " << lim << "us</th>";
+            else
+                ss << "<th>more</th>";
+        }
+        ss << "</tr>\n";
+        for( int t = 0; t < ApplyCounters::OpTypes; t++ ) {
+            if( all.apply.opCount[t] == 0 )
+                continue;
+            ss << tr() << td(ApplyCounters::opTypeName(t)) << td(all.apply.opCount[t])
+               << td(all.apply.opMicros[t] / all.apply.opCount[t]);
+            for( int k = 0; k < ApplyCounters::LatencyBuckets; k++ )
+                ss << td(all.apply.opLatency[t][k]);
+            ss << _tr();
+        }
+        ss << _table();
+    }
+
+    /* major page faults of the whole process so far, -1 if we can't tell here (linux only for now) */
+    static long long pageFaults() {
+        ProcessInfo p;
+        if( !p.supported() )
+            return -1;
+        BSONObjBuilder b;
+        p.getExtraInfo(b);
+        BSONObj o = b.done();
+        return o.hasField("page_faults") ? o["page_faults"].numberLong() : -1;
+    }
+
+    /* takes a snapshot for statsHistory every IntervalSecs */
+    void ReplSetImpl::statsThread() {
+        setThreadName("rsStats");
+        while( !inShutdown() ) {
+            try {
+                ReplStatsSnapshot s;
+                s.created = curTimeMicros64();
+                s.apply = _applyStats.counters();
+                s.fetch = _buffer.counters();
+                s.applied = lastOpTimeWritten;
+                const Member *p = box.getPrimary();
+                if( p == _self )
+                    s.primary = lastOpTimeWritten;
+                else if( p )
+                    s.primary = p->hbinfo().opTime;
+                s.pageFaults = pageFaults();
+                statsHistory.take(s);
+            }
+            catch(std::exception& e) {
+                log() << "replSet error in statsThread " << e.what() << rsLog;
+            }
+            sleepsecs(ReplStatsHistory::IntervalSecs);
+        }
+    }
+
+}
@@ -25,6 +25,246 @@ namespace mongo {
     using namespace bson;
     extern unsigned replSetForceInitialSyncFailure;
 
+    /* most ops syncTail() applies under one lock acquisition */
+    static const unsigned ApplyBatchOps = 5000;
+
+    /* sync source selection, see getSyncSource() */
+    static const int MaxSyncSourceLagSecs = 30;      // a secondary further behind the primary than this isn't used
+    static const int ChainingMinPingGainMillis = 10; // how much closer than the primary a secondary has to be
+    static const int SyncSourceRecheckSecs = 60;     // how often we look for a closer member while syncing
+
+    ApplyStats::ApplyStats() : _m("ApplyStats"), _lastBatch(0), _maxBatch(0) { 
+    }
+
+    void ApplyStats::gotBatch(const ApplyCounters& batch) { 
+        scoped_lock lk(_m);
+        _c.add(batch);
+        _lastBatch = (int) batch.ops;
+        if( _lastBatch > _maxBatch )
+            _maxBatch = _lastBatch;
+    }
+
+    ApplyCounters ApplyStats::counters() const { 
+        scoped_lock lk(_m);
+        return _c;
+    }
+
+    void ApplyStats::append(BSONObjBuilder& b) const { 
+        scoped_lock lk(_m);
+        b.appendNumber("batches", _c.batches);
+        b.appendNumber("ops", _c.ops);
+        b.append("lastBatchSize", _lastBatch);
+        b.append("maxBatchSize", _maxBatch);
+        b.appendNumber("applyMillis", _c.micros / 1000);
+        b.appendNumber("lockWaitMillis", _c.lockWaitMicros / 1000);
+        b.append("opsPerSecApplying", _c.micros ? _c.ops * 1000000.0 / _c.micros : 0.0);
+    }
+
+    OplogBuffer::OplogBuffer() : _m("OplogBuffer"), _bytes(0), _finished(false), _stopped(false),
+                                 _lastFetchMicros(0), _fullWaits(0) { 
+    }
+
+    void OplogBuffer::reset() { 
+        scoped_lock lk(_m);
+        _q.clear();
+        _bytes = 0;
+        _finished = false;
+        _stopped = false;
+    }
+
+    bool OplogBuffer::push(const BSONObj& o) { 
+        scoped_lock lk(_m);
+        if( !_q.empty() && _bytes + o.objsize() > MaxBytes && !_stopped ) {
+            _fullWaits++;
+            while( !_q.empty() && _bytes + o.objsize() > MaxBytes && !_stopped )
+                _notFull.wait(lk.boost());
+        }
+        if( _stopped )
+            return false;
+        _q.push_back(o);
+        _bytes += o.objsize();
+        _c.bytes += o.objsize();
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    void OplogBuffer::finish() { 
+        scoped_lock lk(_m);
+        _finished = true;
+        _notEmpty.notify_all();
+    }
+
+    void OplogBuffer::gotFetch(long long micros) { 
+        scoped_lock lk(_m);
+        _c.fetches++;
+        _c.micros += micros;
+        _lastFetchMicros = micros;
+    }
+
+    FetchCounters OplogBuffer::counters() const { 
+        scoped_lock lk(_m);
+        return _c;
+    }
+
+    bool OplogBuffer::pop(vector<BSONObj>& v, unsigned max, int millis) { 
+        scoped_lock lk(_m);
+        if( _q.empty() && !_finished ) { 
+            boost::xtime xt;
+            boost::xtime_get(&xt, boost::TIME_UTC);
+            unsigned long long ns = millis * 1000000ULL;
+            xt.sec += (xt.nsec + ns) / 1000000000;
+            xt.nsec = (xtime::xtime_nsec_t) ((xt.nsec + ns) % 1000000000);
+            while( _q.empty() && !_finished ) {
+                if( !_notEmpty.timed_wait(lk.boost(), xt) )
+                    break;
+            }
+        }
+        while( !_q.empty() && v.size() < max ) { 
+            _bytes -= _q.front().objsize();
+            v.push_back(_q.front());
+            _q.pop_front();
+        }
+        if( !v.empty() )
+            _notFull.notify_one();
+        return !v.empty();
+    }
+
+    bool OplogBuffer::finished() const { 
+        scoped_lock lk(_m);
+        return _finished && _q.empty();
+    }
+
+    void OplogBuffer::stop() { 
+        scoped_lock lk(_m);
+        _stopped = true;
+        _notFull.notify_all();
+    }
+
+    bool OplogBuffer::stopped() const { 
+        scoped_lock lk(_m);
+        return _stopped;
+    }
+
+    void OplogBuffer::append(BSONObjBuilder& b) const { 
+        scoped_lock lk(_m);
+        b.append("bufferCount", (int) _q.size());
+        b.appendNumber("bufferBytes", _bytes);
+        b.appendNumber("bufferMaxBytes", MaxBytes);
+        b.appendNumber("fetches", _c.fetches);
+        b.append("avgFetchMillis", _c.fetches ? _c.micros / 1000.0 / _c.fetches : 0.0);
+        b.appendNumber("bytesReceived", _c.bytes);
+        b.append("lastFetchMillis", _lastFetchMicros / 1000.0);
+        b.appendNumber("bufferFullWaits", _fullWaits);
+    }
+
+    SyncSourceFeedback::SyncSourceFeedback() : _m("SyncSourceFeedback") { 
+    }
+
+    void SyncSourceFeedback::setTarget(const string& hostport) { 
+        scoped_lock lk(_m);
+        _target = hostport;
+        _changed.notify_all();
+    }
+
+    string SyncSourceFeedback::target() const { 
+        scoped_lock lk(_m);
+        return _target;
+    }
+
+    void SyncSourceFeedback::gotPosition(const BSONObj& rid, const string& host, OpTime ot) { 
+        scoped_lock lk(_m);
+        for( unsigned i = 0; i < _pending.size(); i++ ) {
+            if( _pending[i].host == host && _pending[i].rid.woCompare(rid) == 0 ) { 
+                if( _pending[i].ot < ot )
+                    _pending[i].ot = ot;
+                return;
+            }
+        }
+        Position p;
+        p.rid = rid.getOwned();
+        p.host = host;
+        p.ot = ot;
+        _pending.push_back(p);
+        _changed.notify_all();
+    }
+
+    void SyncSourceFeedback::run() { 
+        setThreadName("rsSyncSourceFeedback");
+        while( 1 ) {
+            vector<Position> v;
+            string target;
+            {
+                scoped_lock lk(_m);
+                while( _pending.empty() || _target.empty() )
+                    _changed.wait(lk.boost());
+                v.swap(_pending);
+                target = _target;
+            }
+
+            BSONObjBuilder cmd;
+            cmd.append("replSetUpdatePosition", 1);
+            {
+                BSONArrayBuilder a(cmd.subarrayStart("positions"));
+                for( unsigned i = 0; i < v.size(); i++ ) {
+                    BSONObjBuilder b(a.subobjStart());
+                    b.append("rid", v[i].rid);
+                    b.append("host", v[i].host);
+                    b.appendTimestamp("optime", v[i].ot.asDate());
+                    b.done();
+                }
+                a.done();
+            }
+
+            /* if this doesn't get through the members will send newer positions soon enough */
+            try {
+                ScopedConn conn(target);
+                BSONObj res;
+                if( !conn.runCommand("admin", cmd.obj(), res) )
+                    log(1) << "replSet couldn't pass member positions on to " << target << ' ' << res.toString() << rsLog;
+            }
+            catch(DBException& e) { 
+                log(1) << "replSet couldn't pass member positions on to " << target << ' ' << e.toString() << rsLog;
+                sleepsecs(1);
+            }
+        }
+    }
+
+    static void pretouchRange(shared_ptr< vector<BSONObj> > ops, unsigned a, unsigned b) { 
+        if( currentClient.get() == 0 )
+            Client::initThread("rsPretouch");
+        for( unsigned i = a; i < b; i++ )
+            pretouchOperation((*ops)[i]);
+    }
+
+    /* with --pretouch n, n threads fault in the documents and index buckets the next batch will touch while 
+       syncTail() applies the current one.  each op is pretouched under its own read lock, so they fit in 
+       between the applier's write lock slices; the page faults are taken there, several at a time, instead 
+       of in the write lock. */
+    void ReplSetImpl::syncPretouch(const shared_ptr< vector<BSONObj> >& ops) { 
+        int nthr = max(1, min(8, cmdLine.pretouch));
+        if( _pretouchPool.get() == 0 )
+            _pretouchPool.reset( new ThreadPool(nthr) );
+        unsigned n = ops->size();
+        unsigned per = (n + nthr - 1) / nthr;
+        for( unsigned a = 0; a < n; a += per )
+            _pretouchPool->schedule(pretouchRange, ops, a, min(n, a + per));
+    }
+
+    /* stops and waits for the fetcher when syncTail() is done, however it leaves.  the fetcher may be 
+       in the middle of a read from the sync source, which ends within a few seconds for a tailable 
+       cursor with await. */
+    class FetcherGuard : boost::noncopyable { 
+    public:
+        FetcherGuard(OplogBuffer& b, boost::thread& t) : _b(b), _t(t) { }
+        ~FetcherGuard() { 
+            _b.stop();
+            _t.join();
+        }
+    private:
+        OplogBuffer& _b;
+        boost::thread& _t;
+    };
+
     /* apply the log op that is in param o */
     void ReplSetImpl::syncApply(const BSONObj &o) {
         char db[MaxDatabaseNameLen];
@@ -71,7 +311,7 @@ namespace mongo {
                 BSONObjBuilder query;
                 query.append("ts", q.done());
                 BSONObj queryObj = query.done();
-                r.query(rsoplog, queryObj);
+                r.query(rsoplog, queryObj, /*exhaust*/true);
             }
             assert( r.haveCursor() );
 
@@ -102,7 +342,6 @@ namespace mongo {
                 }
             }
 
-            // todo : use exhaust
             unsigned long long n = 0;
             while( 1 ) { 
 
@@ -176,18 +415,211 @@ namespace mongo {
         return golive;
     }
 
-    /* tail the primary's oplog.  ok to return, will be re-called. */
+    /* applies a batch of ops from the primary under one write lock, and then writes them to our oplog in 
+       one go.  if applying the batch takes long the lock is released and taken again in between, so 
+       readers on this secondary aren't locked out.
+
+       the ops are applied one after another.  splitting them up by namespace/_id and applying them on 
+       several threads would need the storage layer to allow concurrent writers, it doesn't (dbMutex).
+
+       @return false if we aren't syncing from primary anymore
+    */
+    bool ReplSetImpl::syncApplyBatch(const vector<BSONObj>& ops, const Member *primary) {
+        const int MaxLockMillis = 100;
+        unsigned i = 0;
+        while( i < ops.size() ) {
+            ApplyCounters c;
+            Timer t;
+            unsigned from = i;
+            writelock lk("");
+            c.lockWaitMicros = t.micros();
+            t.reset();
+
+            /* if we have become primary, we dont' want to apply things from elsewhere
+               anymore. assumePrimary is in the db lock so we are safe as long as 
+               we check after we locked above. */
+            if( box.getPrimary() != primary ) {
+                if( box.getState().primary() )
+                    log(0) << "replSet stopping syncTail we are now primary" << rsLog;
+                return false;
+            }
+
+            try {
+                do {
+                    Timer op;
+                    syncApply(ops[i]);
+                    c.gotOp(ops[i], op.micros());
+                    i++;
+                } while( i < ops.size() && t.millis() < MaxLockMillis );
+            }
+            catch(...) {
+                /* with repl sets we write the ops to our oplog too.  log the ones we applied, we'll 
+                   resume after them */
+                _logOpObjsRS(ops, from, i);
+                throw;
+            }
+            _logOpObjsRS(ops, from, i);
+            c.batches = 1;
+            c.micros = t.micros();
+            _applyStats.gotBatch(c);
+        }
+        return true;
+    }
+
+    /* how far a sync source is from us.  secondaries count as ChainingMinPingGainMillis further than they 
+       are, so we only chain off one that is clearly closer than the primary. */
+    static int syncDistance(const Member *m, const Member *primary) { 
+        int ping = max(m->hbinfo().ping, 0);
+        return m == primary ? ping : ping + ChainingMinPingGainMillis;
+    }
+
+    void ReplSetImpl::vetoSyncSource(const Member *m, int secs) { 
+        _syncSourceVetoes[m->fullName()] = time(0) + secs;
+    }
+
+    bool ReplSetImpl::vetoed(const Member *m) { 
+        map<string,time_t>::iterator i = _syncSourceVetoes.find(m->fullName());
+        if( i == _syncSourceVetoes.end() )
+            return false;
+        if( i->second > time(0) )
+            return true;
+        _syncSourceVetoes.erase(i);
+        return false;
+    }
+
+    /* the member to tail the oplog of, by heartbeat ping times.  that is the primary unless a secondary is 
+       closer, e.g. in our own data center while the primary is in another one; then only one member has to 
+       pull each op over the slow link.  a secondary qualifies if it is up, ahead of us (so two secondaries 
+       never sync off each other), within MaxSyncSourceLagSecs of the primary and not delayed.
+       @return 0 if there is no one to sync from
+    */
+    const Member* ReplSetImpl::getSyncSource(const Member *primary) {
+        string forced = forcedSyncSource();
+        if( !forced.empty() ) { 
+            /* replSetSyncFrom: we don't care how close it is, only that it can be synced from */
+            for( Member *m = head(); m; m = m->next() ) {
+                if( m->fullName() != forced )
+                    continue;
+                if( m->hbinfo().up() && (m == primary || m->state() == MemberState::RS_SECONDARY) && 
+                    m->hbinfo().opTime >= lastOpTimeWritten && !vetoed(m) )
+                    return m;
+                break;
+            }
+        }
+
+        const Member *best = primary->hbinfo().up() ? primary : 0;
+        for( Member *m = head(); m; m = m->next() ) {
+            if( m == primary || !m->hbinfo().up() || m->state() != MemberState::RS_SECONDARY )
+                continue;
+            if( m->hbinfo().ping < 0 || m->config().slaveDelay || m->config().hidden )
+                continue;
+            if( _buildIndexes && !m->config().buildIndexes )
+                continue;
+            if( m->hbinfo().opTime <= lastOpTimeWritten )
+                continue;
+            if( primary->hbinfo().opTime.getSecs() > m->hbinfo().opTime.getSecs() + MaxSyncSourceLagSecs )
+                continue;
+            if( vetoed(m) )
+                continue;
+            if( best == 0 || syncDistance(m, primary) < syncDistance(best, primary) )
+                best = m;
+        }
+        return best;
+    }
+
+    /* replSetSyncFrom.  sticks until called again with an empty host or the process restarts.  the sync 
+       thread switches between batches, and only while host is up, secondary or primary and not behind us.
+    */
+    bool ReplSetImpl::_syncFrom(const string& host, string& errmsg) { 
+        lock lk(this);
+        if( !host.empty() ) { 
+            Member *m = head();
+            while( m && m->fullName() != host )
+                m = m->next();
+            if( m == 0 ) { 
+                errmsg = str::stream() << host << " is not another member of the set";
+                return false;
+            }
+            if( m->config().arbiterOnly ) { 
+                errmsg = str::stream() << host << " is an arbiter";
+                return false;
+            }
+            log() << "replSet syncing from " << host << " when possible, set by replSetSyncFrom" << rsLog;
+        }
+        else if( !_forcedSyncSource.empty() ) {
+            log() << "replSet no longer forced to sync from " << _forcedSyncSource << rsLog;
+        }
+        _forcedSyncSource = host;
+        return true;
+    }
+
+    /* checked between batches.  lastCheck is when we last looked for a closer member. */
+    bool ReplSetImpl::shouldChangeSyncSource(const Member *source, const Member *primary, time_t& lastCheck) { 
+        if( !source->hbinfo().up() ) { 
+            log() << "replSet sync source " << source->fullName() << " is down" << rsLog;
+            return true;
+        }
+        if( source != primary ) {
+            if( source->state() != MemberState::RS_SECONDARY ) { 
+                log() << "replSet sync source " << source->fullName() << " is no longer secondary" << rsLog;
+                return true;
+            }
+            if( primary->hbinfo().opTime.getSecs() > source->hbinfo().opTime.getSecs() + MaxSyncSourceLagSecs ) { 
+                log() << "replSet sync source " << source->fullName() << " is more than " << MaxSyncSourceLagSecs 
+                      << " seconds behind the primary" << rsLog;
+                vetoSyncSource(source, SyncSourceRecheckSecs);
+                return true;
+            }
+        }
+        string forced = forcedSyncSource();
+        if( !forced.empty() && forced != source->fullName() ) { 
+            const Member *m = getSyncSource(primary);
+            if( m && m != source ) { 
+                log() << "replSet sync source changed to " << m->fullName() << " by replSetSyncFrom" << rsLog;
+                return true;
+            }
+        }
+        if( forced != source->fullName() && time(0) - lastCheck >= SyncSourceRecheckSecs ) {
+            lastCheck = time(0);
+            const Member *m = getSyncSource(primary);
+            if( m && m != source && syncDistance(m, primary) < syncDistance(source, primary) ) { 
+                log() << "replSet " << m->fullName() << " is closer than sync source " << source->fullName() << rsLog;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* tail the sync source's oplog.  ok to return, will be re-called. */
     void ReplSetImpl::syncTail() { 
         // todo : locking vis a vis the mgr...
 
         const Member *primary = box.getPrimary();
         if( primary == 0 ) return;
-        string hn = primary->h().toString();
+        const Member *source = getSyncSource(primary);
+        if( source == 0 ) return;
+        string hn = source->h().toString();
+        if( hn != syncSourceFeedback.target() ) 
+            log() << "replSet syncing from " << hn << (source == primary ? " (primary)" : "") << rsLog;
         OplogReader r;
-        if( !r.connect(primary->h().toString()) ) { 
+        if( !r.connect(hn) ) { 
             log(2) << "replSet can't connect to " << hn << " to read operations" << rsLog;
+            if( source != primary )
+                vetoSyncSource(source, SyncSourceRecheckSecs);
             return;
         }
+        syncSourceFeedback.setTarget(hn);
+
+        /* who we are in local.slaves on the primary, as in the handshake r.connect() sent */
+        BSONObj me;
+        {
+            readlock lk("local.me");
+            BSONObj o;
+            if( Helpers::getSingleton("local.me", o) )
+                me = BSON("_id" << o["_id"]);
+        }
+        if( !me.isEmpty() )
+            syncSourceFeedback.gotPosition(me, myConfig().h.toString(), lastOpTimeWritten);
 
         /* first make sure we are not hopelessly out of sync by being very stale. */
         {
@@ -200,6 +632,12 @@ namespace mongo {
                 log() << "replSet lastOpTimeWritten: " << lastOpTimeWritten.toStringLong() << rsLog;
                 log() << "replSet our state: " << state().toString() << rsLog;
             }
+            if( lastOpTimeWritten < ts && source != primary ) { 
+                /* the primary may still have what we need */
+                log() << "replSet " << hn << " doesn't have our last op anymore, trying another sync source" << rsLog;
+                vetoSyncSource(source, 10 * 60);
+                return;
+            }
             if( lastOpTimeWritten < ts ) { 
                 log() << "replSet error RS102 too stale to catch up, at least from primary: " << hn << rsLog;
                 log() << "replSet our last optime : " << lastOpTimeWritten.toStringLong() << rsLog;
@@ -212,7 +650,9 @@ namespace mongo {
             }
         }
 
-        r.tailingQueryGTE(rsoplog, lastOpTimeWritten);
+        /* exhaust, so syncFetch() doesn't wait a round trip per batch.  getLastError w doesn't go by how far 
+           we have read, we send what we applied with replSetUpdatePosition (see reportsApplied in replHandshake) */
+        r.tailingQueryGTE(rsoplog, lastOpTimeWritten, /*exhaust*/true);
         assert( r.haveCursor() );
         assert( r.awaitCapable() );
 
@@ -227,6 +667,12 @@ namespace mongo {
                         return;
                     }
                     OpTime theirTS = theirLastOp["ts"]._opTime();
+                    if( theirTS < lastOpTimeWritten && source != primary ) { 
+                        /* a secondary can just be behind us.  only the primary says what to roll back. */
+                        log() << "replSet sync source " << hn << " is behind us, trying another" << rsLog;
+                        vetoSyncSource(source, SyncSourceRecheckSecs);
+                        return;
+                    }
                     if( theirTS < lastOpTimeWritten ) { 
                         log() << "replSet we are ahead of the primary, will try to roll back" << rsLog;
                         syncRollback(r);
@@ -256,7 +702,12 @@ namespace mongo {
             long long h = o["h"].numberLong();
             if( ts != lastOpTimeWritten || h != lastH ) { 
                 log() << "replSet our last op time written: " << lastOpTimeWritten.toStringPretty() << endl;
-                log() << "replset primary's GTE: " << ts.toStringPretty() << endl;
+                log() << "replset sync source's GTE: " << ts.toStringPretty() << endl;
+                if( source != primary ) {
+                    log() << "replSet sync source " << hn << " doesn't have our last op, trying another" << rsLog;
+                    vetoSyncSource(source, SyncSourceRecheckSecs);
+                    return;
+                }
                 syncRollback(r);
                 return;
             }
@@ -268,99 +719,145 @@ namespace mongo {
             tryToGoLiveAsASecondary(minvalid);
         }
 
+        /* a fetcher thread reads ahead into _buffer while we apply, so reading from the sync source 
+           overlaps with applying instead of adding to it */
+        _buffer.reset();
+        string fetchErr;
+        boost::thread fetcher( boost::bind(&ReplSetImpl::syncFetch, this, &r, &fetchErr) );
+        FetcherGuard guard(_buffer, fetcher);
+        time_t lastSourceCheck = time(0);
+        shared_ptr< vector<BSONObj> > ahead; // the next batch, being pretouched
+
         while( 1 ) {
-            while( 1 ) {
-                if( !r.moreInCurrentBatch() ) { 
-                    /* we need to occasionally check some things. between 
-                       batches is probably a good time. */
-
-                    /* perhaps we should check this earlier? but not before the rollback checks. */
-                    if( state().recovering() ) { 
-                        /* can we go to RS_SECONDARY state?  we can if not too old and if minvalid achieved */
-                        OpTime minvalid;
-                        bool golive = ReplSetImpl::tryToGoLiveAsASecondary(minvalid);
-                        if( golive ) {
-                            ;
-                        }
-                        else { 
-                            sethbmsg(str::stream() << "still syncing, not yet to minValid optime" << minvalid.toString());
-                        }
+            int sd = myConfig().slaveDelay;
+            // ignore slaveDelay if the box is still initializing. once
+            // it becomes secondary we can worry about it.
+            bool delay = sd && box.getState().secondary();
+
+            /* with a slaveDelay each op has to wait its turn, so it goes alone */
+            vector<BSONObj> batch;
+            if( ahead ) { 
+                /* the pretouch tasks index into *ahead, and this is the batch they pretouch, so let them finish */
+                _pretouchPool->join();
+                batch.swap(*ahead);
+                ahead.reset();
+            }
+            else if( !_buffer.pop(batch, delay ? 1 : ApplyBatchOps, 1000) && _buffer.finished() ) {
+                if( !fetchErr.empty() )
+                    log() << "replSet syncTail error reading from " << hn << ' ' << fetchErr << rsLog;
+                else
+                    log(1) << "replSet end syncTail pass with " << hn << rsLog;
+                // TODO : reuse our connection to the sync source.
+                return;
+            }
 
-                        /* todo: too stale capability */
-                    }
+            /* we need to occasionally check some things. between 
+               batches is probably a good time. */
 
-                    if( box.getPrimary() != primary ) 
-                        return;
+            /* perhaps we should check this earlier? but not before the rollback checks. */
+            if( state().recovering() ) { 
+                /* can we go to RS_SECONDARY state?  we can if not too old and if minvalid achieved */
+                OpTime minvalid;
+                bool golive = ReplSetImpl::tryToGoLiveAsASecondary(minvalid);
+                if( golive ) {
+                    ;
                 }
-                if( !r.more() )
-                    break;
-                { 
-                    BSONObj o = r.nextSafe(); /* note we might get "not master" at some point */
-
-                    int sd = myConfig().slaveDelay;
-                    // ignore slaveDelay if the box is still initializing. once
-                    // it becomes secondary we can worry about it.
-                    if( sd && box.getState().secondary() ) { 
-                        const OpTime ts = o["ts"]._opTime();
-                        long long a = ts.getSecs();
-                        long long b = time(0);
-                        long long lag = b - a;
-                        long long sleeptime = sd - lag;
-                        if( sleeptime > 0 ) {
-                            uassert(12000, "rs slaveDelay differential too big check clocks and systems", sleeptime < 0x40000000);
-                            log() << "replSet temp slavedelay sleep:" << sleeptime << rsLog;
-                            if( sleeptime < 60 ) {
-                                sleepsecs((int) sleeptime);
-                            }
-                            else {
-                                // sleep(hours) would prevent reconfigs from taking effect & such!
-                                long long waitUntil = b + sleeptime;
-                                while( 1 ) {
-                                    sleepsecs(6);
-                                    if( time(0) >= waitUntil )
-                                        break;
-                                    if( box.getPrimary() != primary )
-                                        break;
-                                    if( myConfig().slaveDelay != sd ) // reconf
-                                        break;
-                                }
-                            }
-                        }
-                        
-                    }
+                else { 
+                    sethbmsg(str::stream() << "still syncing, not yet to minValid optime" << minvalid.toString());
+                }
+
+                /* todo: too stale capability */
+            }
 
-                    {
-                        writelock lk("");
+            if( box.getPrimary() != primary ) 
+                return;
 
-                        /* if we have become primary, we dont' want to apply things from elsewhere
-                           anymore. assumePrimary is in the db lock so we are safe as long as 
-                           we check after we locked above. */
-                        if( box.getPrimary() != primary ) {
-                            if( box.getState().primary() )
-                                log(0) << "replSet stopping syncTail we are now primary" << rsLog;
-                            return;
-                        }
+            if( shouldChangeSyncSource(source, primary, lastSourceCheck) )
+                return;
 
-                        syncApply(o);
-                        _logOpObjRS(o);   /* with repl sets we write the ops to our oplog too: */                   
+            if( batch.empty() )
+                continue;
+
+            if( delay ) { 
+                const OpTime ts = batch[0]["ts"]._opTime();
+                long long a = ts.getSecs();
+                long long b = time(0);
+                long long lag = b - a;
+                long long sleeptime = sd - lag;
+                if( sleeptime > 0 ) {
+                    uassert(12000, "rs slaveDelay differential too big check clocks and systems", sleeptime < 0x40000000);
+                    log() << "replSet temp slavedelay sleep:" << sleeptime << rsLog;
+                    if( sleeptime < 60 ) {
+                        sleepsecs((int) sleeptime);
+                    }
+                    else {
+                        // sleep(hours) would prevent reconfigs from taking effect & such!
+                        long long waitUntil = b + sleeptime;
+                        while( 1 ) {
+                            sleepsecs(6);
+                            if( time(0) >= waitUntil )
+                                break;
+                            if( box.getPrimary() != primary )
+                                break;
+                            if( myConfig().slaveDelay != sd ) // reconf
+                                break;
+                        }
                     }
                 }
             }
-            r.tailCheck();
-            if( !r.haveCursor() ) {
-                log(1) << "replSet end syncTail pass with " << hn << rsLog;
-                // TODO : reuse our connection to the primary.
-                return;
+
+            if( cmdLine.pretouch && !delay ) {
+                ahead.reset( new vector<BSONObj>() );
+                if( _buffer.pop(*ahead, ApplyBatchOps, 0) )
+                    syncPretouch(ahead);
+                else
+                    ahead.reset();
             }
-            if( box.getPrimary() != primary )
+
+            if( !syncApplyBatch(batch, primary) )
                 return;
-            // looping back is ok because this is a tailable cursor
+
+            /* getLastError w on the primary goes by this, not by how far syncFetch() has read */
+            if( !me.isEmpty() )
+                syncSourceFeedback.gotPosition(me, myConfig().h.toString(), lastOpTimeWritten);
+        }
+    }
+
+    /* runs on its own thread for syncTail(), reading ops from the sync source into _buffer until the 
+       cursor dies, an error, or syncTail() is done with it.  the cursor is tailable, so more() waits 
+       a few seconds at the end of the oplog before giving up.
+    */
+    void ReplSetImpl::syncFetch(OplogReader *r, string *err) {
+        setThreadName("rsFetch");
+        try {
+            while( !_buffer.stopped() ) {
+                while( 1 ) {
+                    bool roundTrip = !r->moreInCurrentBatch();
+                    Timer t;
+                    if( !r->more() )
+                        break;
+                    if( roundTrip )
+                        _buffer.gotFetch(t.micros());
+                    /* note we might get "not master" at some point */
+                    if( !_buffer.push(r->nextSafe().getOwned()) )
+                        break; // stopped
+                }
+                r->tailCheck();
+                if( !r->haveCursor() )
+                    break;
+                // looping back is ok because this is a tailable cursor
+            }
+        }
+        catch(std::exception& e) { 
+            *err = e.what();
         }
+        _buffer.finish();
     }
 
     void ReplSetImpl::_syncThread() {
         StateBox::SP sp = box.get();
         if( sp.state.primary() ) {
+            syncSourceFeedback.setTarget("");
             sleepsecs(1);
             return;
         }
@@ -369,7 +866,8 @@ namespace mongo {
             return;
         }
 
-        /* later, we can sync from up secondaries if we want. tbd. */
+        /* we may sync from a secondary (see getSyncSource()), but only while there is a primary, so 
+           there is something to check for rollbacks against */
         if( sp.primary == 0 ) {
             return;
         }
@@ -25,6 +25,7 @@
 #include "../util/mongoutils/str.h"
 #include "../client/dbclient.h"
 #include "replpair.h"
+#include "repl/rs.h"
 
 //#define REPLDEBUG(x) log() << "replBlock: "  << x << endl;
 #define REPLDEBUG(x)
@@ -115,7 +116,12 @@ namespace mongo {
             REPLDEBUG( host << " " << rid << " " << ns << " " << last );
 
             scoped_lock mylk(_mutex);
-            
+            _update( rid , host , ns , last );
+            if ( ! _waiters.empty() )
+                _wakeWaiters( last );
+        }
+
+        void _update( const BSONObj& rid , const string& host , const string& ns , OpTime last ){
 #ifdef _DEBUG
             MongoFileAllowWrites allowWrites;
 #endif
@@ -159,8 +165,69 @@ namespace mongo {
             if ( w <= 1 || ! _isMaster() )
                 return true;
 
-            w--; // now this is the # of slaves i need
             scoped_lock mylk(_mutex);
+            return _replicatedEnough( op , w );
+        }
+
+        /**
+         * blocks until op is on w-1 slaves or millis pass.  waiters are kept by optime and woken by
+         * update() once a slave reaches theirs, so there is no polling.
+         * @return true if replicated enough
+         */
+        bool waitForReplication( OpTime op , int w , int millis ){
+            if ( w <= 1 || ! _isMaster() )
+                return true;
+
+            scoped_lock mylk(_mutex);
+            if ( _replicatedEnough( op , w ) )
+                return true;
+            if ( millis <= 0 )
+                return false;
+
+            Waiter me( w );
+            Waiters::iterator pos = _waiters.insert( make_pair( op , &me ) );
+
+            boost::xtime xt;
+            boost::xtime_get( &xt, boost::TIME_UTC );
+            unsigned long long ns = millis * 1000000ULL;
+            xt.sec += ( xt.nsec + ns ) / 1000000000;
+            xt.nsec = (xtime::xtime_nsec_t) ( ( xt.nsec + ns ) % 1000000000 );
+
+            while ( ! me.done ){
+                if ( ! me.wakeup.timed_wait( mylk.boost() , xt ) )
+                    break;
+            }
+            if ( ! me.done )
+                _waiters.erase( pos ); // _wakeWaiters() removes the ones it wakes
+            return me.done;
+        }
+
+    private:
+        struct Waiter {
+            Waiter( int w ) : w(w) , done(false){}
+            int w;
+            bool done;
+            boost::condition wakeup;
+        };
+        typedef multimap<OpTime,Waiter*> Waiters;
+
+        /* a slave got to last, so the waiters for optimes up to it may be done */
+        void _wakeWaiters( OpTime last ){
+            Waiters::iterator i = _waiters.begin();
+            Waiters::iterator end = _waiters.upper_bound( last );
+            while ( i != end ){
+                if ( ! _replicatedEnough( i->first , i->second->w ) ){
+                    ++i;
+                    continue;
+                }
+                i->second->done = true;
+                i->second->wakeup.notify_one();
+                _waiters.erase( i++ );
+            }
+        }
+
+        bool _replicatedEnough( OpTime op , int w ){
+            w--; // now this is the # of slaves i need
             for ( map<Ident,Info>::iterator i=_slaves.begin(); i!=_slaves.end(); i++){
                 OpTime s = *(i->second.loc);
                 if ( s < op ){
@@ -172,9 +239,11 @@ namespace mongo {
             return w <= 0;
         }
         
+    public:
         // need to be careful not to deadlock with this
         mongo::mutex _mutex;
         map<Ident,Info> _slaves;
+        Waiters _waiters; // getLastError calls with w, by the optime they wait for
         bool _dirty;
         bool _started;
 
@@ -194,13 +263,29 @@ namespace mongo {
         if ( rid.isEmpty() )
             return;
 
-        slaveTracking.update( rid , curop.getRemoteString( false ) , ns , lastOp );
+        // replica set members read ahead of what they have applied, and tell us the latter themselves
+        if ( c->getHandshake()["reportsApplied"].trueValue() )
+            return;
+
+        updateSlaveLocation( rid , curop.getRemoteString( false ) , ns , lastOp );
+    }
+
+    void updateSlaveLocation( const BSONObj& rid , const string& host , const char * ns , OpTime lastOp ){
+        slaveTracking.update( rid , host , ns , lastOp );
+
+        // a secondary someone chains off: the primary is who counts for getLastError w
+        if ( theReplSet && ! theReplSet->isPrimary() )
+            theReplSet->syncSourceFeedback.gotPosition( rid , host , lastOp );
     }
 
     bool opReplicatedEnough( OpTime op , int w ){
         return slaveTracking.opReplicatedEnough( op , w );
     }
 
+    bool waitForReplication( OpTime op , int w , int millis ){
+        return slaveTracking.waitForReplication( op , w , millis );
+    }
+
     void resetSlaveCache(){
         slaveTracking.reset();
     }
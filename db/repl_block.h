@@ -29,6 +29,10 @@
 namespace mongo {
     
     void updateSlaveLocation( CurOp& curop, const char * ns , OpTime lastOp );
+    /** for a position passed on by a replica set member the slave syncs from, see replSetUpdatePosition */
+    void updateSlaveLocation( const BSONObj& rid , const string& host , const char * ns , OpTime lastOp );
     bool opReplicatedEnough( OpTime op , int w );
+    /** waits up to millis for op to get to w-1 slaves, without polling. @return true if it did */
+    bool waitForReplication( OpTime op , int w , int millis );
     void resetSlaveCache();
 }
@@ -0,0 +1,125 @@
+// sparseindex.cpp
+
+/**
+*    Copyright (C) 2008 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pch.h"
+#include "namespace-inl.h"
+#include "jsobj.h"
+#include "index.h"
+#include "queryutil.h"
+
+/**
+ * sparse index: { a : "sparse" } or { a : "sparse" , b : "sparse" }
+ * documents that have none of the indexed fields get no index entry at all,
+ * instead of the null key a normal index would store for them.
+ * keys are ordered ascending, exactly like { a : 1 , b : 1 }
+ */
+namespace mongo {
+
+    string SPARSENAME = "sparse";
+
+    class SparseIndex : public IndexType {
+    public:
+
+        SparseIndex( const IndexPlugin* plugin , const IndexSpec* spec )
+            : IndexType( plugin , spec ){
+
+            BSONObjBuilder orderBuilder;
+            BSONObjIterator i( spec->keyPattern );
+            while ( i.more() ){
+                BSONElement e = i.next();
+                _fields.push_back( e.fieldName() );
+                orderBuilder.append( e.fieldName() , 1 );
+            }
+            _keyGenerator.reset( new IndexSpec( orderBuilder.obj() ) );
+        }
+
+        void getKeys( const BSONObj &obj, BSONObjSetDefaultOrder &keys ) const {
+            if ( ! hasAnyField( obj ) )
+                return;
+            _keyGenerator->getKeys( obj , keys );
+        }
+
+        shared_ptr<Cursor> newCursor( const BSONObj& query , const BSONObj& order , int numWanted ) const {
+            uasserted( 13530 , "sparse index doesn't support special queries" );
+            return shared_ptr<Cursor>();
+        }
+
+        /**
+         * a document missing every indexed field has no entry, so the index
+         * can only answer queries that could never match such a document.
+         * that's the case when at least one indexed field has a range that excludes null,
+         * or is required by { $exists : true } - then the index holds exactly the candidates.
+         * { $exists : false } and null equality need the missing documents, so stay USELESS
+         */
+        IndexSuitability suitability( const BSONObj& query , const BSONObj& order ) const {
+            if ( query.isEmpty() )
+                return USELESS;
+
+            FieldRangeSet frs( "" , query );
+            for ( unsigned i=0; i<_fields.size(); i++ ){
+                const FieldRange& fr = frs.range( _fields[i].c_str() );
+                if ( fr.exists() )
+                    return OPTIMAL;
+                if ( fr.nontrivial() && ! rangeIncludesNull( fr ) )
+                    return IndexType::suitability( query , order );
+            }
+            return USELESS;
+        }
+
+    private:
+
+        bool hasAnyField( const BSONObj& obj ) const {
+            for ( unsigned i=0; i<_fields.size(); i++ ){
+                BSONElementSet all;
+                obj.getFieldsDotted( _fields[i].c_str() , all );
+                if ( all.size() )
+                    return true;
+            }
+            return false;
+        }
+
+        bool rangeIncludesNull( const FieldRange& fr ) const {
+            BSONElement n = _spec->missingField();
+            const vector<FieldInterval>& intervals = fr.intervals();
+            for ( unsigned i=0; i<intervals.size(); i++ ){
+                const FieldInterval& fi = intervals[i];
+                int l = n.woCompare( fi._lower._bound , false );
+                int u = n.woCompare( fi._upper._bound , false );
+                if ( ( l > 0 || ( l == 0 && fi._lower._inclusive ) ) &&
+                     ( u < 0 || ( u == 0 && fi._upper._inclusive ) ) )
+                    return true;
+            }
+            return false;
+        }
+
+        vector<string> _fields;
+        auto_ptr<IndexSpec> _keyGenerator;
+    };
+
+    class SparseIndexPlugin : public IndexPlugin {
+    public:
+        SparseIndexPlugin() : IndexPlugin( SPARSENAME ){
+        }
+
+        virtual IndexType* generate( const IndexSpec* spec ) const {
+            return new SparseIndex( this , spec );
+        }
+
+    } sparseIndexPlugin;
+
+}
@@ -24,6 +24,7 @@
 #include "../util/array.h"
 #include "../util/text.h"
 #include "../util/queue.h"
+#include "../util/buffer_pool.h"
 
 namespace BasicTests {
 
@@ -527,6 +528,34 @@ namespace BasicTests {
         }
     };
 
+    class BufferPoolTest {
+    public:
+        void run(){
+            char *a = bufferPool.get( 1000 );
+            ASSERT_EQUALS( 1024 , BufferPool::capacity( a ) );
+            bufferPool.release( a );
+            ASSERT( a == bufferPool.get( 1024 ) ); // same thread gets it back
+            bufferPool.release( a );
+
+            char *big = bufferPool.get( 100 * 1024 * 1024 );
+            ASSERT_EQUALS( 100 * 1024 * 1024 , BufferPool::capacity( big ) );
+            bufferPool.release( big );
+
+            BufBuilder b( 16 , &bufferPool );
+            for ( int i=0; i<10000; i++ )
+                b.appendNum( i );
+            for ( int i=0; i<10000; i++ )
+                ASSERT_EQUALS( i , ((int*)b.buf())[i] );
+            ASSERT( BufferPool::capacity( b.buf() ) >= b.len() );
+
+            Message m;
+            m.appendData( b.buf() , b.len() , true );
+            b.decouple();
+            ASSERT_EQUALS( 40000 , m.size() );
+            m.reset();
+        }
+    };
+
     class All : public Suite {
     public:
         All() : Suite( "basic" ){
@@ -556,6 +585,7 @@ namespace BasicTests {
             add< IsValidUTF8Test >();
 
             add< QueueTest >();
+            add< BufferPoolTest >();
         }
     } myall;
     
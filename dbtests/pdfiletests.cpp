@@ -22,6 +22,8 @@
 
 #include "../db/db.h"
 #include "../db/json.h"
+#include "../db/dbhelpers.h"
+#include "../db/btree.h"
 
 #include "dbtests.h"
 
@@ -303,6 +305,68 @@ namespace PdfileTests {
             }
         };
     } // namespace Insert
+
+    namespace RemoveRange {
+
+        class Base {
+        public:
+            Base() : _context( ns() ){
+            }
+            virtual ~Base() {
+                if ( !nsd() )
+                    return;
+                string n( ns() );
+                dropNS( n );
+            }
+        protected:
+            static const char *ns() {
+                return "unittests.pdfiletests.RemoveRange";
+            }
+            static NamespaceDetails *nsd() {
+                return nsdetails( ns() );
+            }
+            int countAll() const {
+                int n = 0;
+                for ( shared_ptr<Cursor> c = theDataFileMgr.findAll( ns() ); c->ok(); c->advance() )
+                    n++;
+                return n;
+            }
+            int countIndex( int idxNo ) const {
+                IndexDetails& id = nsd()->idx( idxNo );
+                int n = 0;
+                BtreeCursor c( nsd() , idxNo , id , minKey , maxKey , true , 1 );
+                for ( ; c.ok(); c.advance() )
+                    n++;
+                return n;
+            }
+        private:
+            dblock lk_;
+            Client::Context _context;
+        };
+
+        /** spans several batches, every index has to lose exactly the removed keys */
+        class MultipleBatches : public Base {
+        public:
+            void run() {
+                int n = 3 * Helpers::RemoveRangeBatchSize;
+                for ( int i=0; i<n; i++ ) {
+                    BSONObj o = BSON( "_id" << i << "a" << i << "b" << ( n - i ) );
+                    theDataFileMgr.insertWithObjMod( ns(), o );
+                }
+                Helpers::ensureIndex( ns() , BSON( "a" << 1 ) , false , "a_1" );
+                Helpers::ensureIndex( ns() , BSON( "b" << 1 ) , false , "b_1" );
+
+                int from = 10;
+                int to = n - 10;
+                long long num = Helpers::removeRange( ns() , BSON( "a" << from ) , BSON( "a" << to ) );
+                ASSERT_EQUALS( to - from , num );
+                ASSERT_EQUALS( n - ( to - from ) , countAll() );
+                for ( int i=0; i<nsd()->nIndexes; i++ )
+                    ASSERT_EQUALS( n - ( to - from ) , countIndex( i ) );
+            }
+        };
+
+    } // namespace RemoveRange
     
     class All : public Suite {
     public:
@@ -323,6 +387,7 @@ namespace PdfileTests {
             add< ScanCapped::FirstInExtent >();
             add< ScanCapped::LastInExtent >();
             add< Insert::UpdateDate >();
+            add< RemoveRange::MultipleBatches >();
         }
     } myall;
 
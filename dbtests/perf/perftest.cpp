@@ -20,10 +20,12 @@
 #include "pch.h"
 
 #include "../../client/dbclient.h"
+#include "../../db/cmdline.h"
 #include "../../db/instance.h"
 #include "../../db/query.h"
 #include "../../db/queryoptimizer.h"
 #include "../../util/file_allocator.h"
+#include "../../util/mmap.h"
 
 #include "../framework.h"
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -539,6 +541,43 @@ namespace QueryTests {
         auto_ptr< DBClientCursor > c_;
     };
 
+    // Index order differs from insertion order, so a scan of the index hops
+    // around the data files.  Readahead only shows up in the numbers when the
+    // files aren't in the os cache, so for a cold measurement drop the page
+    // cache yourself between setup and run; the test doesn't touch system state.
+    class ScanIndexScattered {
+    public:
+        ScanIndexScattered() : ns_( testNs( this ) ), readahead_( 4 ) {
+            setup();
+        }
+        ScanIndexScattered( const string &ns, int readahead ) : ns_( ns ), readahead_( readahead ) {
+            setup();
+        }
+        void setup() {
+            for( int i = 0; i < 200000; ++i )
+                client_->insert( ns_.c_str(), BSON( "a" << ( i * 7919 ) % 200000 << "b" << string( 100, 'x' ) ) );
+            client_->ensureIndex( ns_, BSON( "a" << 1 ) );
+            MongoFile::flushAll( true );
+        }
+        void run() {
+            int old = cmdLine.btreeReadahead;
+            cmdLine.btreeReadahead = readahead_;
+            auto_ptr< DBClientCursor > c =
+            client_->query( ns_.c_str(), QUERY( "a" << GT << -1 ).hint( BSON( "a" << 1 ) ) );
+            int i = 0;
+            for( ; c->more(); c->nextSafe(), ++i );
+            cmdLine.btreeReadahead = old;
+            ASSERT_EQUALS( 200000, i );
+        }
+        string ns_;
+        int readahead_;
+    };
+
+    class ScanIndexScatteredNoReadahead : public ScanIndexScattered {
+    public:
+        ScanIndexScatteredNoReadahead() : ScanIndexScattered( testNs( this ), 0 ) {}
+    };
+
     class All : public RunnerSuite {
     public:
         All() : RunnerSuite( "query" ){}
@@ -551,6 +590,8 @@ namespace QueryTests {
             add< GetMore >();
             add< GetMoreIndex >();
             add< GetMoreKeyMatchHelps >();
+            add< ScanIndexScattered >();
+            add< ScanIndexScatteredNoReadahead >();
         }
     } all;
 
@@ -1215,6 +1215,40 @@ namespace QueryOptimizerTests {
             }
         };        
         
+        class SparseExists : public Base {
+        public:
+            void run() {
+                Helpers::ensureIndex( ns(), BSON( "a" << "sparse" ), false, "a_sparse" );
+                BSONObj one = BSON( "a" << 1 );
+                BSONObj isNull = fromjson( "{a:null}" );
+                BSONObj missing = BSON( "b" << 1 );
+                theDataFileMgr.insertWithObjMod( ns(), one );
+                theDataFileMgr.insertWithObjMod( ns(), isNull );
+                theDataFileMgr.insertWithObjMod( ns(), missing );
+
+                // every document with the field is in the index, so it alone answers $exists:true
+                BSONObj exists = fromjson( "{a:{$exists:true}}" );
+                auto_ptr< FieldRangeSet > frs( new FieldRangeSet( ns(), exists ) );
+                auto_ptr< FieldRangeSet > frsOrig( new FieldRangeSet( *frs ) );
+                QueryPlanSet s( ns(), frs, frsOrig, exists, BSONObj() );
+                ASSERT_EQUALS( 1, s.nPlans() );
+                ASSERT_EQUALS( BSON( "a" << "sparse" ), s.getBestGuess()->indexKey() );
+
+                // the missing document has no entry, so these need a table scan
+                BSONObj notExists = fromjson( "{a:{$exists:false}}" );
+                auto_ptr< FieldRangeSet > frs2( new FieldRangeSet( ns(), notExists ) );
+                auto_ptr< FieldRangeSet > frsOrig2( new FieldRangeSet( *frs2 ) );
+                QueryPlanSet s2( ns(), frs2, frsOrig2, notExists, BSONObj() );
+                ASSERT_EQUALS( 1, s2.nPlans() );
+                ASSERT( s2.getBestGuess()->indexKey().woCompare( BSON( "a" << "sparse" ) ) != 0 );
+
+                string err;
+                ASSERT_EQUALS( 2, runCount( ns(), BSON( "query" << exists ), err ) );
+                ASSERT_EQUALS( 1, runCount( ns(), BSON( "query" << notExists ), err ) );
+                ASSERT_EQUALS( 2, runCount( ns(), BSON( "query" << isNull ), err ) );
+            }
+        };
+        
         class SingleException : public Base {
         public:
             void run() {
@@ -1765,6 +1799,7 @@ namespace QueryOptimizerTests {
             add< QueryPlanSetTests::Count >();
             add< QueryPlanSetTests::QueryMissingNs >();
             add< QueryPlanSetTests::UnhelpfulIndex >();
+            add< QueryPlanSetTests::SparseExists >();
             add< QueryPlanSetTests::SingleException >();
             add< QueryPlanSetTests::AllException >();
             add< QueryPlanSetTests::SaveGoodIndex >();
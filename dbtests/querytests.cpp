@@ -29,10 +29,6 @@
 
 #include "dbtests.h"
 
-namespace mongo {
-    extern int __findingStartInitialTimeout;
-}
-
 namespace QueryTests {
 
     class Base {
@@ -991,16 +987,12 @@ namespace QueryTests {
 
     class FindingStart : public CollectionBase {
     public:
-        FindingStart() : CollectionBase( "findingstart" ), _old( __findingStartInitialTimeout ) {
-            __findingStartInitialTimeout = 0;
-        }
-        ~FindingStart() {
-            __findingStartInitialTimeout = _old;
+        FindingStart( int nExtents = 5 ) : CollectionBase( "findingstart" ), _nExtents( nExtents ) {
         }
         
         void run() {
             BSONObj info;
-            ASSERT( client().runCommand( "unittests", BSON( "create" << "querytests.findingstart" << "capped" << true << "size" << 1000 << "$nExtents" << 5 << "autoIndexId" << false ), info ) );
+            ASSERT( client().runCommand( "unittests", BSON( "create" << "querytests.findingstart" << "capped" << true << "size" << 200 * _nExtents << "$nExtents" << _nExtents << "autoIndexId" << false ), info ) );
             
             int i = 0;
             for( int oldCount = -1;
@@ -1021,16 +1013,18 @@ namespace QueryTests {
         }
         
     private:
-        int _old;
+        int _nExtents;
+    };
+
+    /* enough extents that the binary search over them takes several steps */
+    class FindingStartManyExtents : public FindingStart {
+    public:
+        FindingStartManyExtents() : FindingStart( 40 ) {}
     };
 
     class FindingStartPartiallyFull : public CollectionBase {
     public:
-        FindingStartPartiallyFull() : CollectionBase( "findingstart" ), _old( __findingStartInitialTimeout ) {
-            __findingStartInitialTimeout = 0;
-        }
-        ~FindingStartPartiallyFull() {
-            __findingStartInitialTimeout = _old;
+        FindingStartPartiallyFull() : CollectionBase( "findingstart" ) {
         }
         
         void run() {
@@ -1052,9 +1046,6 @@ namespace QueryTests {
                 }
             }
         }
-        
-    private:
-        int _old;
     };
         
     
@@ -1181,6 +1172,7 @@ namespace QueryTests {
             add< HelperTest >();
             add< HelperByIdTest >();
             add< FindingStart >();
+            add< FindingStartManyExtents >();
             add< FindingStartPartiallyFull >();
             add< WhatsMyUri >();
             
@@ -0,0 +1,49 @@
+// per operation class concurrency limits, see db/admission.h
+
+t = db.jstests_admission1;
+t.drop();
+t.save( { a : 1 } );
+db.getLastError();
+
+function stats(){
+    return db.serverStatus().admission;
+}
+
+a = db.adminCommand( { admission : 1 } );
+assert( a.ok , "A" );
+[ "reads" , "writes" , "commands" , "longRunning" ].forEach( function( c ){ assert( a[c] , "B " + c ); } );
+
+assert( ! db.adminCommand( { admission : 1 , reads : -1 } ).ok , "C" );
+
+before = stats();
+t.findOne();
+assert.lt( before.reads.admitted , stats().reads.admitted , "D" );
+
+// one long running command at a time, the second one queues behind the first
+assert.eq( 1 , db.adminCommand( { admission : 1 , longRunning : 1 } ).longRunning.limit , "E" );
+before = stats().longRunning;
+
+slowGroup = "db.jstests_admission1.group( { key : { a : 1 } , initial : { n : 0 } , " +
+            "reduce : function( o , p ){ var s = new Date(); while ( new Date() - s < 2000 ); p.n++; } } );";
+s1 = startParallelShell( slowGroup );
+assert.soon( function(){ return stats().longRunning.active == 1; } , "F" );
+s2 = startParallelShell( slowGroup );
+assert.soon( function(){ return stats().longRunning.waiting == 1; } , "G" );
+
+// other classes aren't held up
+assert.eq( 1 , t.count() , "H" );
+
+// the queued op is in currentOp and can be killed while it waits
+queued = db.currentOp().inprog.filter( function( o ){ return o.msg == "waiting for admission"; } );
+assert.eq( 1 , queued.length , "H2 " + tojson( db.currentOp() ) );
+db.killOp( queued[0].opid );
+assert.soon( function(){ return stats().longRunning.waiting == 0; } , "H3" );
+s2();
+s1();
+
+after = stats().longRunning;
+assert.eq( 0 , after.active , "I" );
+assert.eq( before.queued , after.queued , "J" );
+
+db.adminCommand( { admission : 1 , longRunning : 0 } );
+t.drop();
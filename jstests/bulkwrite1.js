@@ -0,0 +1,47 @@
+// bulkWrite command: mixed inserts, updates and removes in one round trip
+
+t = db.jstests_bulkwrite1;
+t.drop();
+
+res = t.bulkWrite( [ { op : "insert" , doc : { _id : 1 , a : 1 } } ,
+                     { op : "insert" , doc : { _id : 2 , a : 2 } } ,
+                     { op : "insert" , doc : { _id : 3 , a : 3 } } ,
+                     { op : "update" , q : { a : { $gte : 2 } } , u : { $inc : { b : 1 } } , multi : true } ,
+                     { op : "update" , q : { _id : 4 } , u : { _id : 4 , a : 4 } , upsert : true } ,
+                     { op : "update" , q : { a : 10 } , u : { $set : { c : 1 } } } ,
+                     { op : "remove" , q : { _id : 1 } } ] );
+printjson( res );
+assert( res.ok , "A" );
+assert.eq( 7 , res.nApplied , "B" );
+assert.eq( 0 , res.nErrors , "C" );
+assert.eq( 7 , res.results.length , "D" );
+assert.eq( 1 , res.results[0].n , "E" );
+assert.eq( 2 , res.results[3].n , "F" );
+assert( res.results[3].updatedExisting , "G" );
+assert( ! res.results[4].updatedExisting , "H" );
+assert.eq( 0 , res.results[5].n , "I" );
+assert.eq( 1 , res.results[6].n , "J" );
+
+assert.eq( [ 2 , 3 , 4 ] , t.find().sort( { _id : 1 } ).map( function( z ){ return z._id; } ) , "K" );
+assert.eq( 2 , t.find( { b : 1 } ).count() , "L" );
+
+// ordered stops at the first error
+res = t.bulkWrite( [ { op : "insert" , doc : { _id : 5 } } ,
+                     { op : "insert" , doc : { _id : 2 } } ,
+                     { op : "insert" , doc : { _id : 6 } } ] );
+assert.eq( 1 , res.nApplied , "M" );
+assert.eq( 1 , res.nErrors , "N" );
+assert.eq( 2 , res.results.length , "O" );
+assert( res.results[1].err , "P" );
+assert.eq( 0 , t.find( { _id : 6 } ).count() , "Q" );
+
+// unordered carries on
+res = t.bulkWrite( [ { op : "insert" , doc : { _id : 7 } } ,
+                     { op : "bogus" } ,
+                     { op : "insert" , doc : { _id : 8 } } ] , false );
+assert.eq( 2 , res.nApplied , "R" );
+assert.eq( 1 , res.nErrors , "S" );
+assert.eq( 3 , res.results.length , "T" );
+assert.eq( 2 , t.find( { _id : { $in : [ 7 , 8 ] } } ).count() , "U" );
+
+assert( ! db.runCommand( { bulkWrite : t.getName() , ops : 5 } ).ok , "V" );
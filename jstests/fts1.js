@@ -0,0 +1,40 @@
+// text index plugin
+
+t = db.fts1;
+t.drop();
+
+t.save( { _id : 1 , d : "Red running shoes for the trail" , price : 50 } );
+t.save( { _id : 2 , d : "Blue shoes" , price : 20 } );
+t.save( { _id : 3 , d : "A red hat" , price : 10 } );
+t.save( { _id : 4 , d : "Shoe polish, red and black. Keeps red shoes shiny." , price : 5 } );
+t.save( { _id : 5 , other : "red shoes" } );
+
+t.ensureIndex( { d : "text" } );
+
+function ids( cursor ){
+    return cursor.map( function(z){ return z._id; } );
+}
+
+assert.eq( [ 2 , 1 , 4 ].sort() , ids( t.find( { d : { $text : "shoes" } } ) ).sort() , "A1" );
+assert.eq( [ 1 ] , ids( t.find( { d : { $text : "run" } } ) ) , "A2 - stemmed" );
+assert.eq( [] , ids( t.find( { d : { $text : "the" } } ) ) , "A3 - stop word" );
+assert.eq( [ 3 , 4 ] , ids( t.find( { d : { $text : "red" } , price : { $lt : 20 } } ) ).sort() , "A4 - filtered" );
+
+res = db.runCommand( { textSearch : "fts1" , search : "red shoes" } );
+assert( res.ok , "B1" );
+assert.eq( 4 , res.results.length , "B2 - " + tojson( res ) );
+assert.eq( 4 , res.results[0].obj._id , "B3 - most relevant first" );
+assert.gte( res.results[0].score , res.results[1].score , "B4" );
+
+res = db.runCommand( { textSearch : "fts1" , search : "red shoes" , limit : 1 } );
+assert.eq( 1 , res.results.length , "C1" );
+
+res = db.runCommand( { textSearch : "fts1" , search : "red shoes" , limit : -1 } );
+assert( ! res.ok , "C1b - negative limit" );
+
+res = db.runCommand( { textSearch : "fts1" , search : "red" , filter : { price : { $gt : 20 } } } );
+assert.eq( 1 , res.results.length , "C2" );
+
+t.update( { _id : 2 } , { $set : { d : "Blue hat" } } );
+assert.eq( [ 1 , 4 ] , ids( t.find( { d : { $text : "shoes" } } ) ).sort() , "D" );
+assert( t.validate().valid , "E" );
@@ -0,0 +1,41 @@
+// sparse index plugin: documents missing the field get no key
+
+t = db.index_sparse1;
+t.drop();
+
+for ( var i=0; i<100; i++ ){
+    var o = { i : i };
+    if ( i % 10 == 0 )
+        o.x = i;
+    t.save( o );
+}
+t.save( { i : 100 , x : null } );
+
+t.ensureIndex( { x : "sparse" } );
+assert.eq( 11 , t.find().hint( { x : "sparse" } ).itcount() , "only docs with x are indexed" );
+
+assert.eq( 1 , t.find( { x : 50 } ).itcount() , "A1" );
+assert.eq( "BtreeCursor x_sparse" , t.find( { x : 50 } ).explain().cursor , "A2" );
+assert.eq( 4 , t.find( { x : { $gt : 55 } } ).itcount() , "B1" );
+assert.eq( "BtreeCursor x_sparse" , t.find( { x : { $gt : 55 } } ).explain().cursor , "B2" );
+
+// null matches missing fields, so the sparse index can't answer these
+assert.eq( 91 , t.find( { x : null } ).itcount() , "C1" );
+assert.eq( "BasicCursor" , t.find( { x : null } ).explain().cursor , "C2" );
+assert.eq( 101 , t.find().sort( { x : 1 } ).itcount() , "D" );
+
+// every doc with x is in the index, so it answers $exists:true on its own
+assert.eq( 11 , t.find( { x : { $exists : true } } ).itcount() , "D1" );
+assert.eq( "BtreeCursor x_sparse" , t.find( { x : { $exists : true } } ).explain().cursor , "D2" );
+assert.eq( 90 , t.find( { x : { $exists : false } } ).itcount() , "D3" );
+assert.eq( "BasicCursor" , t.find( { x : { $exists : false } } ).explain().cursor , "D4" );
+
+// recorded plan for { x : <equality> } must not be reused for null
+t.find( { x : 50 } ).itcount();
+assert.eq( 91 , t.find( { x : null } ).itcount() , "E" );
+
+t.update( { i : 1 } , { $set : { x : 1 } } );
+assert.eq( 1 , t.find( { x : 1 } ).itcount() , "F1" );
+t.update( { i : 1 } , { $unset : { x : 1 } } );
+assert.eq( 0 , t.find( { x : 1 } ).itcount() , "F2" );
+assert( t.validate().valid , "G" );
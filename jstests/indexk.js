@@ -0,0 +1,27 @@
+// background index builds insert keys in batches; check builds that span several batches
+
+t = db.jstests_indexk;
+t.drop();
+
+N = 5000;
+for ( var i=0; i<N; i++ ){
+    t.save( { a : ( i * 7 ) % N , b : [ i , i + N ] , c : i % 1000 } );
+}
+db.getLastError();
+
+t.ensureIndex( { a : 1 } , { background : true } );
+assert.eq( N , t.find().hint( { a : 1 } ).itcount() , "A1" );
+var last = -1;
+t.find().hint( { a : 1 } ).forEach( function( z ){ assert( z.a > last , "A2" ); last = z.a; } );
+
+t.ensureIndex( { b : 1 } , { background : true } );
+assert.eq( 2 * N , t.find( { b : { $gte : 0 } } ).hint( { b : 1 } ).explain().nscanned , "B1" );
+assert.eq( 1 , t.find( { b : N + 10 } ).itcount() , "B2" );
+
+// dups spread over every batch are all dropped
+t.ensureIndex( { c : 1 } , { background : true , unique : true , dropDups : true } );
+assert.eq( 1000 , t.count() , "C1" );
+assert.eq( 1000 , t.find().hint( { c : 1 } ).itcount() , "C2" );
+assert.eq( 1000 , t.find().hint( { a : 1 } ).itcount() , "C3" );
+assert.eq( 1000 , t.find( { b : { $gte : 0 } } ).hint( { b : 1 } ).explain().nscanned / 2 , "C4" );
+assert( t.validate().valid , "C5" );
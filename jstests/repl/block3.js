@@ -0,0 +1,32 @@
+// one getLastError w:2 after a batch of writes waits for the whole batch
+
+var rt = new ReplTest( "block3" );
+
+m = rt.start( true );
+s = rt.start( false );
+
+dbm = m.getDB( "foo" );
+dbs = s.getDB( "foo" );
+
+tm = dbm.bar;
+ts = dbs.bar;
+
+tm.save( { x : -1 } );
+assert.eq( null , dbm.getLastError( 2 ) , "A" );
+
+for ( var i=0; i<1000; i++ )
+    tm.save( { x : i } );
+var res = dbm.getLastErrorObj( 2 , 30000 );
+assert.eq( null , res.err , "B" );
+assert( ! res.wtimeout , "C" );
+assert.eq( 1001 , ts.count() , "D" );
+
+// the wait ends about when wtimeout says, not later
+rt.stop( false );
+tm.save( { x : 1000 } );
+var start = new Date();
+res = dbm.getLastErrorObj( 2 , 300 );
+assert( res.wtimeout , "E" );
+assert.gt( 2000 , ( new Date() ) - start , "F" );
+
+rt.stop();
@@ -0,0 +1,44 @@
+// secondaries apply the oplog in batches, and the ops still come out right and in order
+
+var rt = new ReplSetTest( { name : "applybatch1" , nodes : 2 } );
+var nodes = rt.startSet();
+rt.initiate();
+
+var master = rt.getMaster();
+var mdb = master.getDB( "test" );
+
+for ( var i=0; i<5000; i++ ){
+    mdb.foo.insert( { _id : i , x : 0 } );
+    if ( i % 3 == 0 )
+        mdb.foo.update( { _id : i } , { $inc : { x : 1 } } );
+    if ( i % 7 == 0 )
+        mdb.foo.remove( { _id : i } );
+}
+mdb.bar.insert( { _id : 1 } );
+assert.eq( null , mdb.getLastError( 2 , 60000 ) , "A" );
+
+rt.awaitReplication();
+
+var slave = rt.liveNodes.slaves[0];
+slave.setSlaveOk();
+var sdb = slave.getDB( "test" );
+
+assert.eq( mdb.foo.count() , sdb.foo.count() , "B" );
+assert.eq( mdb.foo.find( { x : 1 } ).count() , sdb.foo.find( { x : 1 } ).count() , "C" );
+assert.eq( 1 , sdb.bar.count() , "D" );
+
+var status = slave.getDB( "admin" ).runCommand( { replSetGetStatus : 1 } );
+var apply = status.apply;
+printjson( apply );
+assert( apply.ops > 0 , "E" );
+assert( apply.batches <= apply.ops , "F" );
+assert( apply.maxBatchSize >= 1 , "G" );
+
+// ops came through the fetcher's buffer, which is drained now
+var fetch = status.fetch;
+printjson( fetch );
+assert( fetch.fetches > 0 , "H" );
+assert.eq( 0 , fetch.bufferCount , "I" );
+assert( fetch.bufferMaxBytes > 0 , "J" );
+
+rt.stopSet();
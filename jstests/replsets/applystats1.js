@@ -0,0 +1,62 @@
+// replSetGetApplyStats shows how a secondary applied the oplog over time, by op type
+
+var rt = new ReplSetTest( { name : "applystats1" , nodes : 2 } );
+rt.startSet();
+rt.initiate();
+// so every op goes through the secondary's normal apply path, not initial sync
+rt.awaitSecondaryNodes();
+
+var master = rt.getMaster();
+var mdb = master.getDB( "test" );
+
+for ( var i=0; i<3000; i++ ){
+    mdb.foo.insert( { _id : i , x : 0 } );
+    if ( i % 2 == 0 )
+        mdb.foo.update( { _id : i } , { $inc : { x : 1 } } );
+    if ( i % 5 == 0 )
+        mdb.foo.remove( { _id : i } );
+}
+assert.eq( null , mdb.getLastError( 2 , 60000 ) , "A" );
+rt.awaitReplication();
+
+var slave = rt.liveNodes.slaves[0];
+var res;
+// a snapshot is taken every few seconds, wait for one that has the ops in it
+assert.soon( function() {
+    res = slave.getDB( "admin" ).runCommand( { replSetGetApplyStats : 1 , n : 100 } );
+    assert.commandWorked( res );
+    var ops = 0;
+    res.intervals.forEach( function( x ) { ops += x.ops; } );
+    return ops >= 3000 + 1500 + 600;
+} , "ops" , 60000 );
+printjson( res.intervals[0] );
+
+assert.eq( 6 , res.latencyBucketsMicros.length , "B" );
+
+var types = {};
+var bytes = 0;
+res.intervals.forEach( function( x ) {
+    assert( x.secs > 0 , "C" );
+    assert( x.lagSecs >= 0 , "D" );
+    bytes += x.bytesReceived;
+    for ( var t in x.opTypes ){
+        var h = x.opTypes[t];
+        assert.eq( 7 , h.latency.length , "E " + t );
+        var n = 0;
+        h.latency.forEach( function( c ) { n += c; } );
+        assert.eq( h.n , n , "F " + t );
+        types[t] = ( types[t] || 0 ) + h.n;
+    }
+} );
+assert.eq( 3000 , types.insert , "G" );
+assert.eq( 1500 , types.update , "H" );
+assert.eq( 600 , types["delete"] , "I" );
+assert( bytes > 0 , "J" );
+
+// newest first
+if ( res.intervals.length > 1 )
+    assert( res.intervals[0].start > res.intervals[1].start , "K" );
+
+assert( slave.getDB( "admin" ).runCommand( { replSetGetApplyStats : 1 , n : 1 } ).intervals.length <= 1 , "L" );
+
+rt.stopSet();
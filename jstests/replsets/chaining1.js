@@ -0,0 +1,51 @@
+// a secondary syncing from another secondary still counts for getLastError w on the primary
+
+var rt = new ReplSetTest( { name : "chaining1" , nodes : 3 } );
+rt.startSet();
+rt.initiate();
+
+var master = rt.getMaster();
+var mdb = master.getDB( "test" );
+rt.awaitSecondaryNodes();
+
+var first = rt.liveNodes.slaves[0];
+var second = rt.liveNodes.slaves[1];
+
+function syncingTo( conn ) {
+    return conn.getDB( "admin" ).runCommand( { replSetGetStatus : 1 } ).syncingTo;
+}
+
+for ( var i=0; i<1000; i++ )
+    mdb.foo.insert( { _id : i } );
+assert.eq( null , mdb.getLastError( 3 , 60000 ) , "A" );
+
+// the primary has no sync source and can't be told to use one
+assert( ! syncingTo( master ) , "B" );
+assert.commandFailed( master.getDB( "admin" ).runCommand( { replSetSyncFrom : first.host } ) , "C" );
+assert.commandFailed( second.getDB( "admin" ).runCommand( { replSetSyncFrom : "nosuchhost:1" } ) , "D" );
+
+// chain second off first
+assert.commandWorked( second.getDB( "admin" ).runCommand( { replSetSyncFrom : first.host } ) , "E" );
+assert.soon( function() {
+    mdb.foo.insert( { x : 1 } ); // the sync thread switches between batches
+    return syncingTo( second ) == first.host;
+} , "F" );
+assert.eq( master.host , syncingTo( first ) , "G" );
+
+// only first reads the primary's oplog now, second's position has to come through it
+for ( var i=0; i<3; i++ ) {
+    mdb.foo.insert( { _id : 1000 + i } );
+    assert.eq( null , mdb.getLastError( 3 , 60000 ) , "H" + i );
+    second.setSlaveOk();
+    assert.eq( 1 , second.getDB( "test" ).foo.find( { _id : 1000 + i } ).itcount() , "I" + i );
+}
+
+// positions that come in through another member count too
+assert.commandWorked( master.getDB( "admin" ).runCommand( { replSetUpdatePosition : 1 , positions : [] } ) , "J" );
+
+// and back to picking by ping time, which is the primary here
+assert.commandWorked( second.getDB( "admin" ).runCommand( { replSetSyncFrom : "" } ) , "K" );
+mdb.foo.insert( { _id : 2000 } );
+assert.eq( null , mdb.getLastError( 3 , 60000 ) , "L" );
+
+rt.stopSet();
@@ -0,0 +1,48 @@
+// initial sync clones several dbs and collections over parallel connections, then builds their indexes
+
+var rt = new ReplSetTest( { name : "initial_sync3" , nodes : 0 } );
+
+var first = rt.add();
+assert.soon( function() {
+    return first.getDB( "admin" ).runCommand( { replSetInitiate : null } ).ok == 1;
+} );
+var master = rt.getMaster();
+
+var dbs = [ "a" , "b" , "c" ];
+for ( var d=0; d<dbs.length; d++ ){
+    var mdb = master.getDB( dbs[d] );
+    for ( var c=0; c<3; c++ ){
+        var coll = mdb.getCollection( "coll" + c );
+        for ( var i=0; i<1000; i++ )
+            coll.insert( { _id : i , x : i % 10 , s : "initial sync " + i } );
+        coll.ensureIndex( { x : 1 } );
+    }
+    mdb.capped.drop();
+    mdb.createCollection( "capped" , { capped : true , size : 10000 } );
+    mdb.capped.insert( { y : 1 } );
+}
+assert.eq( null , master.getDB( "a" ).getLastError() , "A" );
+
+// the new member has to do an initial sync of everything
+rt.add();
+rt.reInitiate();
+rt.awaitSecondaryNodes();
+rt.awaitReplication();
+
+var slave = rt.liveNodes.slaves[0];
+slave.setSlaveOk();
+
+for ( var d=0; d<dbs.length; d++ ){
+    var mdb = master.getDB( dbs[d] );
+    var sdb = slave.getDB( dbs[d] );
+    for ( var c=0; c<3; c++ ){
+        var name = "coll" + c;
+        assert.eq( 1000 , sdb.getCollection( name ).count() , "B " + dbs[d] + "." + name );
+        assert.eq( mdb.getCollection( name ).getIndexes().length , sdb.getCollection( name ).getIndexes().length , "C " + dbs[d] + "." + name );
+        assert.eq( 100 , sdb.getCollection( name ).find( { x : 3 } ).hint( { x : 1 } ).itcount() , "D " + dbs[d] + "." + name );
+    }
+    assert( sdb.capped.isCapped() , "E " + dbs[d] );
+    assert.eq( 1 , sdb.capped.count() , "F " + dbs[d] );
+}
+
+rt.stopSet();
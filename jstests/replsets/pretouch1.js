@@ -0,0 +1,51 @@
+// with --pretouch, secondaries fault in the next batch while applying one, and still end up with the same data
+
+var rt = new ReplSetTest( { name : "pretouch1" , nodes : 2 } );
+rt.startSet( { pretouch : 4 } );
+rt.initiate();
+
+var master = rt.getMaster();
+var mdb = master.getDB( "test" );
+mdb.foo.ensureIndex( { x : 1 } );
+mdb.foo.ensureIndex( { tags : 1 } );
+
+for ( var i=0; i<20000; i++ ){
+    mdb.foo.insert( { _id : i , x : i % 100 , tags : [ "a" + ( i % 7 ) , "b" + ( i % 11 ) ] } );
+    if ( i % 3 == 0 )
+        mdb.foo.update( { _id : i } , { $inc : { x : 1 } } );
+    if ( i % 5 == 0 )
+        mdb.foo.remove( { _id : i } );
+}
+assert.eq( null , mdb.getLastError( 2 , 120000 ) , "A" );
+
+rt.awaitReplication();
+
+var slave = rt.liveNodes.slaves[0];
+slave.setSlaveOk();
+var sdb = slave.getDB( "test" );
+
+assert.eq( mdb.foo.count() , sdb.foo.count() , "B" );
+assert.eq( mdb.foo.find( { x : 1 } ).count() , sdb.foo.find( { x : 1 } ).hint( { x : 1 } ).count() , "C" );
+assert.eq( mdb.foo.find( { tags : "a3" } ).count() , sdb.foo.find( { tags : "a3" } ).hint( { tags : 1 } ).count() , "D" );
+assert( sdb.foo.validate().valid , "E" );
+
+// ops with many index keys take longer to pretouch than to apply, so a batch is taken while its
+// pretouch is still going.  that has to wait for the pretouch rather than take the ops from under it
+mdb.bar.ensureIndex( { k : 1 } );
+mdb.bar.ensureIndex( { k : -1 , n : 1 } );
+mdb.bar.ensureIndex( { n : 1 , k : 1 } );
+var keys = [];
+for ( var i=0; i<500; i++ )
+    keys.push( "key" + i );
+for ( var i=0; i<2000; i++ ){
+    mdb.bar.insert( { _id : i , n : i , k : keys } );
+    if ( i % 2 == 0 )
+        mdb.bar.remove( { _id : i - 1 } );
+}
+assert.eq( null , mdb.getLastError( 2 , 300000 ) , "F" );
+
+assert.eq( mdb.bar.count() , sdb.bar.count() , "G" );
+assert.eq( mdb.bar.count() , sdb.bar.find( { k : "key499" } ).hint( { k : 1 } ).count() , "H" );
+assert( sdb.bar.validate().valid , "I" );
+
+rt.stopSet();
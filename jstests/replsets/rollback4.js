@@ -0,0 +1,68 @@
+// a rollback that has to refetch more documents than fit in one refetch query, from several collections
+
+load("jstests/replsets/rslib.js");
+
+var replTest = new ReplSetTest({ name: 'rollback4', nodes: 3 });
+var nodes = replTest.nodeList();
+
+var conns = replTest.startSet();
+replTest.initiate({ "_id": "rollback4",
+    "members": [
+        { "_id": 0, "host": nodes[0] },
+        { "_id": 1, "host": nodes[1] },
+        { "_id": 2, "host": nodes[2], arbiterOnly: true}]
+});
+
+var master = replTest.getMaster();
+var a_conn = conns[0];
+var b_conn = conns[1];
+assert(master == a_conn, "conns[0] assumed to be master");
+a_conn.setSlaveOk();
+b_conn.setSlaveOk();
+var A = a_conn.getDB("admin");
+var B = b_conn.getDB("admin");
+var a = a_conn.getDB("foo");
+var b = b_conn.getDB("foo");
+
+var N = 2500;
+for (var i = 0; i < N; i++) {
+    a.bar.insert({ _id: i, x: 0 });
+    a.baz.insert({ _id: "k" + i, x: 0 });
+}
+assert.eq(null, a.getLastError(2, 60000), "A");
+
+// b becomes primary while a can't see it, and changes every document
+A.runCommand({ replSetTest: 1, blind: true });
+reconnect(a);
+reconnect(b);
+wait(function () { return B.isMaster().ismaster; });
+
+b.bar.update({}, { $set: { x: 1} }, false, true);
+b.baz.update({}, { $set: { x: 1} }, false, true);
+for (var i = N; i < N + 100; i++)
+    b.bar.insert({ _id: i, x: 1 });
+b.bar.remove({ _id: { $lt: 100} });
+assert.eq(null, b.getLastError(), "B");
+
+// a comes back as primary, b has to roll all of that back
+B.runCommand({ replSetTest: 1, blind: true });
+reconnect(a);
+reconnect(b);
+A.runCommand({ replSetTest: 1, blind: false });
+reconnect(a);
+wait(function () { try { return A.isMaster().ismaster; } catch (e) { return false; } });
+a.bar.insert({ _id: -1, x: 2 });
+
+B.runCommand({ replSetTest: 1, blind: false });
+reconnect(b);
+wait(function () { try { return B.isMaster().secondary; } catch (e) { return false; } });
+replTest.awaitReplication();
+
+assert.eq(N + 1, b.bar.count(), "C");
+assert.eq(N, b.baz.count(), "D");
+assert.eq(0, b.bar.find({ x: 1 }).count(), "E");
+assert.eq(0, b.baz.find({ x: 1 }).count(), "F");
+friendlyEqual(a.bar.find().sort({ _id: 1 }).toArray(), b.bar.find().sort({ _id: 1 }).toArray(), "bar differs");
+friendlyEqual(a.baz.find().sort({ _id: 1 }).toArray(), b.baz.find().sort({ _id: 1 }).toArray(), "baz differs");
+
+replTest.stopSet(15);
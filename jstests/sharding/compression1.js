@@ -0,0 +1,46 @@
+// mongos compressing its connections to the shards with --networkCompression
+
+s = new ShardingTest( "compression1" , 2 , 0 , 1 , { mongosOptions : { networkCompression : "" } } );
+
+if ( ! s.shard0.getDB( "admin" ).runCommand( "ismaster" ).compression ){
+    print( "compression1.js: built without compression support, skipping" );
+    s.stop();
+}
+else {
+
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+// big and repetitive so it compresses, and a few small ones that go in the envelope as is
+big = "";
+while ( big.length < 10000 )
+    big += "compress me ";
+
+for ( var i=0; i<100; i++ )
+    db.foo.insert( { num : i , big : big } );
+db.foo.insert( { num : -1 } );
+assert.eq( null , db.getLastError() , "A" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 50 } } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 50 } , to : s.getOther( s.getServer( "test" ) ).name } );
+
+assert.eq( 101 , db.foo.find().itcount() , "B" );
+assert.eq( big , db.foo.findOne( { num : 77 } ).big , "C" );
+assert.eq( -1 , db.foo.findOne( { num : -1 } ).num , "D" );
+
+// the shards saw compressed requests from mongos and answer compressed
+function compressed( conn ){
+    var total = 0;
+    conn.getDB( "admin" ).$cmd.sys.inprog.findOne( { $all : 1 } ).inprog.forEach(
+        function( op ){
+            if ( op.compression && op.compression.enabled )
+                total += op.compression.uncompressedBytesOut - op.compression.compressedBytesOut;
+        } );
+    return total;
+}
+assert.lt( 0 , compressed( s.shard0 ) + compressed( s.shard1 ) , "E" );
+
+s.stop();
+}
@@ -0,0 +1,44 @@
+// mongodump through mongos uses exhaust cursors, for sharded and unsharded collections
+
+s = new ShardingTest( "exhaust1" , 2 , 0 , 1 );
+
+assert( s.getDB( "admin" ).runCommand( "availablequeryoptions" ).options & 64 , "mongos should offer exhaust" );
+
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.sharded" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+big = "";
+while ( big.length < 1000 )
+    big += "x";
+
+// enough for many batches
+for ( var i=0; i<5000; i++ ){
+    db.sharded.insert( { num : i , big : big } );
+    db.unsharded.insert( { num : i , big : big } );
+}
+assert.eq( null , db.getLastError() , "A" );
+
+s.adminCommand( { split : "test.sharded" , middle : { num : 2500 } } );
+s.adminCommand( { movechunk : "test.sharded" , find : { num : 2500 } , to : s.getOther( s.getServer( "test" ) ).name } );
+
+var data = "/data/db/exhaust1-dump/";
+resetDbpath( data );
+assert.eq( 0 , runMongoProgram( "mongodump" , "--host" , s.s.host , "--db" , "test" , "--out" , data ) , "dump" );
+
+var port = 30040;
+var conn = startMongodTest( port , "exhaust1-restore" );
+assert.eq( 0 , runMongoProgram( "mongorestore" , "--host" , "127.0.0.1:" + port , "--dir" , data ) , "restore" );
+
+var restored = conn.getDB( "test" );
+assert.eq( 5000 , restored.sharded.count() , "B" );
+assert.eq( 5000 , restored.unsharded.count() , "C" );
+assert.eq( big , restored.sharded.findOne( { num : 4999 } ).big , "D" );
+
+// the connection to mongos still works after the streams
+assert.eq( 5000 , db.sharded.find().itcount() , "E" );
+assert.eq( 5000 , db.unsharded.find().itcount() , "F" );
+
+stopMongod( port );
+s.stop();
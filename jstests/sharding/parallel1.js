@@ -0,0 +1,67 @@
+// unsorted queries over several shards go to all of them at once, and still honour skip and limit
+
+s = new ShardingTest( "parallel1" , 3 , 0 , 1 );
+
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+big = "";
+while ( big.length < 1000 )
+    big += "x";
+
+N = 6000;
+for ( var i=0; i<N; i++ )
+    db.foo.insert( { num : i , big : big } );
+assert.eq( null , db.getLastError() , "A" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 2000 } } );
+s.adminCommand( { split : "test.foo" , middle : { num : 4000 } } );
+var primary = s.getServer( "test" ).name;
+var others = s._connections.filter( function( z ) { return z.name != primary; } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 2000 } , to : others[0].name } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 4000 } , to : others[1].name } );
+assert.eq( 3 , s.onNumShards( "foo" ) , "B" );
+
+assert.eq( "ParallelUnordered" , db.foo.find().explain().clusteredType , "C" );
+
+// every document exactly once, over many batches from each shard
+var seen = {};
+var n = 0;
+db.foo.find().forEach( function( z ) { assert( ! seen[z.num] , "dup " + z.num ); seen[z.num] = true; n++; } );
+assert.eq( N , n , "D" );
+
+assert.eq( 100 , db.foo.find().limit( 100 ).itcount() , "E" );
+assert.eq( N - 100 , db.foo.find().skip( 100 ).itcount() , "F" );
+assert.eq( 50 , db.foo.find().skip( 5000 ).limit( 50 ).itcount() , "G" );
+assert.eq( 0 , db.foo.find().skip( N ).itcount() , "H" );
+assert.eq( 20 , db.foo.find().batchSize( 7 ).limit( 20 ).itcount() , "I" );
+assert.eq( 10 , db.foo.find( { num : { $lt : 10 } } ).itcount() , "J" );
+assert.eq( 1000 , db.foo.find( { num : { $gte : 1500 , $lt : 2500 } } ).itcount() , "K" );
+
+// a cursor left open doesn't hold up the others
+function threads(){
+    return s.getDB( "admin" ).runCommand( { serverStatus : 1 } ).extra_info.threads; // linux only
+}
+var before = threads();
+var c = db.foo.find().batchSize( 10 );
+c.next();
+assert.eq( N , db.foo.find().itcount() , "L" );
+assert( c.hasNext() , "M" );
+
+// nor does it keep threads, many of them open on 3 shards cost no more than one
+var open = [];
+for ( var i=0; i<30; i++ ){
+    open.push( db.foo.find().batchSize( 10 ) );
+    open[i].next();
+}
+if ( before != undefined )
+    assert.gt( 10 , threads() - before , "N" );
+open.forEach( function( z ) { assert( z.hasNext() , "O" ); } );
+
+// sorted queries still merge
+var last = -1;
+db.foo.find().sort( { num : 1 } ).limit( 3000 ).forEach( function( z ) { assert( z.num > last , "sort" ); last = z.num; } );
+
+s.stop();
@@ -0,0 +1,56 @@
+// sorted queries over several shards are sent to all of them at once and merged
+
+s = new ShardingTest( "parallel2" , 3 , 0 , 1 );
+
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+big = "";
+while ( big.length < 500 )
+    big += "x";
+
+N = 6000;
+for ( var i=0; i<N; i++ )
+    db.foo.insert( { num : i , x : ( i * 7 ) % 1000 , big : big } );
+assert.eq( null , db.getLastError() , "A" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 2000 } } );
+s.adminCommand( { split : "test.foo" , middle : { num : 4000 } } );
+var primary = s.getServer( "test" ).name;
+var others = s._connections.filter( function( z ) { return z.name != primary; } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 2000 } , to : others[0].name } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 4000 } , to : others[1].name } );
+assert.eq( 3 , s.onNumShards( "foo" ) , "B" );
+
+function check( cursor , n , cmp , msg ){
+    var a = cursor.toArray();
+    assert.eq( n , a.length , msg + " count" );
+    for ( var i=1; i<a.length; i++ )
+        assert( cmp( a[i-1] , a[i] ) <= 0 , msg + " order at " + i );
+    return a;
+}
+
+// every shard has documents all over the range of x, with many equal x's
+var byX = function( a , b ){ return a.x - b.x; };
+var a = check( db.foo.find().sort( { x : 1 } ) , N , byX , "C" );
+assert.eq( 0 , a[0].x , "D" );
+assert.eq( 999 , a[N-1].x , "E" );
+
+check( db.foo.find().sort( { x : -1 } ) , N , function( a , b ){ return b.x - a.x; } , "F" );
+check( db.foo.find().sort( { x : 1 , num : -1 } ) , N , function( a , b ){ return a.x - b.x || b.num - a.num; } , "G" );
+
+var b = check( db.foo.find().sort( { x : 1 } ).skip( 100 ).limit( 50 ) , 50 , byX , "H" );
+assert.eq( a[100].x , b[0].x , "I" );
+check( db.foo.find().sort( { x : 1 } ).batchSize( 5 ).limit( 12 ) , 12 , byX , "J" );
+check( db.foo.find().sort( { num : 1 } ).skip( N - 10 ) , 10 , function( a , b ){ return a.num - b.num; } , "K" );
+check( db.foo.find( { x : { $lt : 10 } } ).sort( { x : 1 } ) , 60 , byX , "L" );
+
+// the sort key is added to a projection that leaves it out
+a = db.foo.find( {} , { num : 1 } ).sort( { x : 1 } ).limit( 5 ).toArray();
+assert.eq( 5 , a.length , "M" );
+
+assert.eq( "ParallelSort" , db.foo.find().sort( { x : 1 } ).explain().clusteredType , "N" );
+
+s.stop();
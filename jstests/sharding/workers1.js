@@ -0,0 +1,50 @@
+// mongos serving connections from a fixed pool of worker threads
+
+s = new ShardingTest( "workers1" , 2 , 0 , 1 , { mongosOptions : { workerThreads : 2 } } );
+
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+// many more connections than workers, used round robin
+conns = [];
+for ( var i=0; i<20; i++ )
+    conns.push( new Mongo( s.s.host ) );
+
+for ( var j=0; j<10; j++ ){
+    for ( var i=0; i<conns.length; i++ ){
+        var db = conns[i].getDB( "test" );
+        db.foo.insert( { num : i * 100 + j , conn : i } );
+        assert.eq( null , db.getLastError() , "A " + i );
+    }
+}
+
+for ( var i=0; i<conns.length; i++ ){
+    assert.eq( 10 , conns[i].getDB( "test" ).foo.find( { conn : i } ).itcount() , "B " + i );
+}
+assert.eq( 200 , s.getDB( "test" ).foo.count() , "C" );
+
+// per connection state is kept across workers
+db = conns[3].getDB( "test" );
+db.foo.insert( { num : 1 , _id : 1 } );
+db.foo.insert( { num : 1 , _id : 1 } );
+conns[4].getDB( "test" ).foo.findOne();
+assert( db.getLastError() , "D" );
+
+// two clients' writes and getLastErrors interleaved: each has to see its own error, and only its own,
+// though with 2 workers they often run on the same thread
+a = conns[5].getDB( "test" );
+b = conns[6].getDB( "test" );
+for ( var j=0; j<20; j++ ){
+    a.foo.insert( { num : 5000 + j , _id : "x" + j } );
+    b.foo.insert( { num : 5000 + j , _id : "x" + j } ); // duplicate of a's
+    conns[ j % conns.length ].getDB( "test" ).foo.findOne();
+    assert.eq( null , a.getLastError() , "E " + j );
+    assert( b.getLastError() , "F " + j );
+
+    b.foo.insert( { num : 6000 + j , _id : "y" + j } );
+    a.foo.insert( { num : 6000 + j , _id : "y" + j } ); // duplicate of b's
+    assert( a.getLastError() , "G " + j );
+    assert.eq( null , b.getLastError() , "H " + j );
+}
+
+s.stop();
@@ -769,6 +769,11 @@ namespace mongo {
                 result.append("ismaster", 1.0 );
                 result.append("msg", "isdbgrid");
                 result.appendNumber("maxBsonObjectSize", BSONObjMaxUserSize);
+                if ( compressionSupported() )
+                    result.append("compression", BSON_ARRAY( "zlib" ) );
+                string sock = makeUnixSockPath( cmdLine.port );
+                if ( ListeningSockets::get()->hasPath( sock ) )
+                    result.append("unixSocket", sock);
                 return true;
             }
         } ismaster;
@@ -155,7 +155,7 @@ namespace mongo {
     void Request::reply( Message & response , const string& fromServer ){
         assert( _didInit );
         long long cursor =response.header()->getCursor();
-        if ( cursor ){
+        if ( cursor && ! isExhaust() ){ // no getMores will come for an exhaust cursor
             cursorCache.storeRef( fromServer , cursor );
         }
         _p->reply( _m , response , _id );
@@ -48,6 +48,11 @@ namespace mongo {
         }
         bool isCommand() const;
 
+        /** a query with QueryOption_Exhaust, which gets all its batches without asking for them */
+        bool isExhaust() const {
+            return op() == dbQuery && ( _m.header()->dataAsInt() & QueryOption_Exhaust );
+        }
+
         MSGID id() const {
             return _id;
         }
@@ -86,9 +86,10 @@ namespace mongo {
             if ( logLevel > 5 ){
                 log(5) << "client id: " << hex << r.getClientId() << "\t" << r.getns() << "\t" << dec << r.op() << endl;
             }
+            // before anything uses a ShardConnection: with --workerThreads this thread served other clients
+            setClientId( r.getClientId() );
             try {
                 r.init();
-                setClientId( r.getClientId() );
                 r.process();
             }
             catch ( DBException& e ){
@@ -108,6 +109,7 @@ namespace mongo {
         virtual void disconnected( AbstractMessagingPort* p ){
             ClientInfo::disconnect( p->getClientId() );
             lastError.disconnect( p->getClientId() );
+            ShardConnection::clientDisconnected( p->getClientId() );
         }
     };
 
@@ -187,6 +189,7 @@ int main(int argc, char* argv[], char *envp[] ) {
         ( "test" , "just run unit tests" )
         ( "upgrade" , "upgrade meta data version" )
         ( "chunkSize" , po::value<int>(), "maximum amount of data per chunk" )
+        ( "workerThreads" , po::value<int>(), "serve client connections from a pool of this many threads (linux only, default is a thread per connection)" )
         ( "ipv6", "enable IPv6 support (disabled by default)" )
         ( "jsonp","allow JSONP access via http (has security implications)" )
         ;
@@ -306,6 +309,8 @@ int main(int argc, char* argv[], char *envp[] ) {
     MessageServer::Options opts;
     opts.port = cmdLine.port;
     opts.ipList = cmdLine.bind_ip;
+    if ( params.count( "workerThreads" ) )
+        opts.workerThreads = params["workerThreads"].as<int>();
     start(opts);
 
     dbexit( EXIT_CLEAN );
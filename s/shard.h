@@ -245,8 +245,11 @@ namespace mongo {
          */
         bool runCommand( const string& db , const BSONObj& cmd , BSONObj& res );
 
-        /** checks all of my thread local connections for the version of this ns */
+        /** checks all of my client's connections for the version of this ns */
         static void checkMyConnectionVersions( const string & ns );
+
+        /** gives back the connections kept for a client, see getClientId() */
+        static void clientDisconnected( int clientId );
         
     private:
         void _init();
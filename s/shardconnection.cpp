@@ -43,7 +43,10 @@ namespace mongo {
 
     /**
      * holds all the actual db connections for a client to various servers
-     * 1 pre thread, so don't have to worry about thread safety
+     * 1 per client (see getClientId()), or per thread where there is no client id.  a client's 
+     * requests are processed one at a time, so don't have to worry about thread safety.
+     * keeping them by client rather than thread matters with --workerThreads, where a client's 
+     * write and its getLastError can run on different threads
      */
     class ClientConnections : boost::noncopyable {
     public:
@@ -171,7 +174,19 @@ namespace mongo {
         
         static thread_specific_ptr<ClientConnections> _perThread;
 
-        static ClientConnections* threadInstance(){
+        static mongo::mutex _perClientLock;
+        static map<int,ClientConnections*>& _perClient;
+
+        static ClientConnections* clientInstance(){
+            int clientId = getClientId();
+            if ( clientId ){
+                scoped_lock lk( _perClientLock );
+                ClientConnections* &cc = _perClient[clientId];
+                if ( ! cc )
+                    cc = new ClientConnections();
+                return cc;
+            }
+
             ClientConnections* cc = _perThread.get();
             if ( ! cc ){
                 cc = new ClientConnections();
@@ -179,9 +194,24 @@ namespace mongo {
             }
             return cc;
         }
+
+        static void clientDisconnected( int clientId ){
+            ClientConnections* cc = 0;
+            {
+                scoped_lock lk( _perClientLock );
+                map<int,ClientConnections*>::iterator i = _perClient.find( clientId );
+                if ( i == _perClient.end() )
+                    return;
+                cc = i->second;
+                _perClient.erase( i );
+            }
+            delete cc; // releases the connections, so not under the lock
+        }
     };
 
     thread_specific_ptr<ClientConnections> ClientConnections::_perThread;
+    mongo::mutex ClientConnections::_perClientLock("ClientConnections");
+    map<int,ClientConnections*>& ClientConnections::_perClient = *(new map<int,ClientConnections*>());
 
     ShardConnection::ShardConnection( const Shard * s , const string& ns )
         : _addr( s->getConnString() ) , _ns( ns ) {
@@ -200,7 +230,7 @@ namespace mongo {
     
     void ShardConnection::_init(){
         assert( _addr.size() );
-        _conn = ClientConnections::threadInstance()->get( _addr , _ns );
+        _conn = ClientConnections::clientInstance()->get( _addr , _ns );
         _finishedInit = false;
     }
 
@@ -220,7 +250,7 @@ namespace mongo {
 
     void ShardConnection::done(){
         if ( _conn ){
-            ClientConnections::threadInstance()->done( _addr , _conn );
+            ClientConnections::clientInstance()->done( _addr , _conn );
             _conn = 0;
             _finishedInit = true;
         }
@@ -235,7 +265,11 @@ namespace mongo {
     }
 
     void ShardConnection::sync(){
-        ClientConnections::threadInstance()->sync();
+        ClientConnections::clientInstance()->sync();
+    }
+
+    void ShardConnection::clientDisconnected( int clientId ){
+        ClientConnections::clientDisconnected( clientId );
     }
 
     bool ShardConnection::runCommand( const string& db , const BSONObj& cmd , BSONObj& res ){
@@ -254,7 +288,7 @@ namespace mongo {
     }
 
     void ShardConnection::checkMyConnectionVersions( const string & ns ){
-        ClientConnections::threadInstance()->checkVersions( ns );
+        ClientConnections::clientInstance()->checkVersions( ns );
     }
 
     ShardConnection::~ShardConnection() {
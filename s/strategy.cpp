@@ -62,6 +62,21 @@ namespace mongo {
 
             uassert( 10200 , "mongos: error calling db", ok);
             r.reply( response , c.getServerAddress() );
+
+            if ( r.isExhaust() ){
+                // the shard sends the rest of the batches on this connection, pass them on as they come.
+                // this client's thread and the shard connection are both taken until the whole result
+                // has been sent, however long that is.  the client couldn't use its connection for
+                // anything else meanwhile anyway, but the shard connection isn't back in the pool.
+                DBConnector& from = c;
+                long long cursor = response.header()->getCursor();
+                while ( cursor ){
+                    Message more;
+                    from.recv( more );
+                    cursor = more.header()->getCursor();
+                    r.reply( more , c.getServerAddress() );
+                }
+            }
             dbcon.done();
         }
         catch ( AssertionException& e ) {
@@ -66,9 +66,12 @@ namespace mongo {
             
             BSONObj sort = query.getSort();
             
-            if ( sort.isEmpty() ){
+            if ( sort.isEmpty() && servers.size() == 1 ){
                 cursor = new SerialServerClusteredCursor( servers , q );
             }
+            else if ( sort.isEmpty() ){
+                cursor = new ParallelUnorderedClusteredCursor( servers , q );
+            }
             else {
                 cursor = new ParallelSortClusteredCursor( servers , q , sort );
             }
@@ -93,6 +96,12 @@ namespace mongo {
             }
 
             ShardedClientCursorPtr cc (new ShardedClientCursor( q , cursor ));
+            if ( r.isExhaust() ){
+                // the client won't ask for more, so send every batch now.  this keeps the client's thread
+                // and the shard cursors' connections busy until the whole merged result is sent.
+                while ( cc->sendNextBatch( r ) );
+                return;
+            }
             if ( ! cc->sendNextBatch( r ) ){
                 return;
             }
@@ -60,6 +60,7 @@ DBCollection.prototype.help = function () {
     print("\tdb." + shortName + ".totalIndexSize() - size in bytes of all the indexes");
     print("\tdb." + shortName + ".totalSize() - storage allocated for all data and indexes");
     print("\tdb." + shortName + ".update(query, object[, upsert_bool, multi_bool])");
+    print("\tdb." + shortName + ".bulkWrite(ops[, ordered_bool]) inserts, updates and removes in one round trip");
     print("\tdb." + shortName + ".validate() - SLOW");
     print("\tdb." + shortName + ".getShardVersion() - only for use with sharding");
     return __magicNoPrint;
@@ -184,6 +185,19 @@ DBCollection.prototype.update = function( query , obj , upsert , multi ){
     this._mongo.update( this._fullName , query , obj , upsert ? true : false , multi ? true : false );
 }
 
+/**
+ * ops: [ { op : "insert" , doc : {...} } ,
+ *        { op : "update" , q : {...} , u : {...} , upsert : false , multi : false } ,
+ *        { op : "remove" , q : {...} , justOne : false } ]
+ * returns the server's reply, with a result per op in results
+ */
+DBCollection.prototype.bulkWrite = function( ops , ordered ){
+    var cmd = { bulkWrite : this.getName() , ops : ops };
+    if ( ordered != undefined )
+        cmd.ordered = ordered ? true : false;
+    return this._db.runCommand( cmd );
+}
+
 DBCollection.prototype.save = function( obj ){
     if ( obj == null || typeof( obj ) == "undefined" ) 
         throw "can't save a null";
@@ -225,7 +225,10 @@ ShardingTest = function( testName , numShards , verboseLevel , numMongos , other
     for ( var i=0; i<(numMongos||1); i++ ){
         var myPort =  startMongosPort - i;
         print("config: "+this._configDB);
-        var conn = startMongos( { port : startMongosPort - i , v : verboseLevel || 0 , configdb : this._configDB }  );
+        var opts = { port : startMongosPort - i , v : verboseLevel || 0 , configdb : this._configDB };
+        for ( var k in otherParams.mongosOptions )
+            opts[k] = otherParams.mongosOptions[k];
+        var conn = startMongos( opts );
         conn.name = localhost + ":" + myPort;
         this._mongos.push( conn );
         if ( i == 0 )
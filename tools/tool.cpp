@@ -176,6 +176,8 @@ namespace mongo {
                     cerr << "couldn't connect to [" << _host << "] " << errmsg << endl;
                     return -1;
                 }
+                if ( _conn->type() == ConnectionString::MASTER )
+                    ((DBClientConnection*)_conn)->setLocalSocket( true );
 
                 (_usesstdout ? cout : cerr ) << "connected to: " << _host << endl;
             }
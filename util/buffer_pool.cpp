@@ -0,0 +1,188 @@
+// buffer_pool.cpp
+
+/*    Copyright 2009 10gen Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "pch.h"
+#include "buffer_pool.h"
+#include "../db/jsobj.h"
+
+namespace mongo {
+
+    BufferPool bufferPool;
+
+    namespace {
+
+        // in front of every buffer we hand out
+        struct Header {
+            int sizeClass;  // -1 : too big for the pool, straight malloc()
+            int size;       // usable bytes
+            long long pad;  // keep the buffer as aligned as malloc() would
+        };
+
+        inline Header* header( const char *buf ) {
+            return (Header*)( buf - sizeof(Header) );
+        }
+
+        inline int classSize( int c ) {
+            return BufferPool::MinSize << c;
+        }
+
+        int sizeClassFor( int size ) {
+            int c = 0;
+            while ( c < BufferPool::NumClasses && classSize( c ) < size )
+                c++;
+            return c < BufferPool::NumClasses ? c : -1;
+        }
+
+        struct Stats {
+            AtomicUInt gets;
+            AtomicUInt threadHits;
+            AtomicUInt sharedHits;
+            AtomicUInt mallocs;
+            AtomicUInt oversize;
+            AtomicUInt releases;
+            AtomicUInt frees;
+        } stats;
+
+        // we "new" these so they are still around when buffers are released during termination
+        mongo::mutex& sharedMutex = *( new mongo::mutex( "BufferPool" ) );
+        vector<char*>* shared = new vector<char*>[ BufferPool::NumClasses ];
+        long long sharedBytes = 0;
+
+        void sharedRelease( char *buf , int c ) {
+            {
+                scoped_lock lk( sharedMutex );
+                if ( sharedBytes + classSize( c ) <= BufferPool::MaxSharedBytes ) {
+                    shared[c].push_back( buf );
+                    sharedBytes += classSize( c );
+                    return;
+                }
+            }
+            stats.frees++;
+            free( header( buf ) );
+        }
+
+        struct ThreadCache {
+            ThreadCache() : bytes(0) {}
+            ~ThreadCache() {
+                for ( int c=0; c<BufferPool::NumClasses; c++ )
+                    for ( unsigned i=0; i<buffers[c].size(); i++ )
+                        sharedRelease( buffers[c][i] , c );
+            }
+            vector<char*> buffers[BufferPool::NumClasses];
+            int bytes;
+        };
+
+        boost::thread_specific_ptr<ThreadCache>& threadCache = *( new boost::thread_specific_ptr<ThreadCache>() );
+    }
+
+    char* BufferPool::get( int size ) {
+        stats.gets++;
+        int c = sizeClassFor( size );
+        if ( c >= 0 ) {
+            if ( classSize( c ) <= MaxThreadCachedSize ) {
+                ThreadCache *tc = threadCache.get();
+                if ( tc && ! tc->buffers[c].empty() ) {
+                    char *buf = tc->buffers[c].back();
+                    tc->buffers[c].pop_back();
+                    tc->bytes -= classSize( c );
+                    stats.threadHits++;
+                    return buf;
+                }
+            }
+
+            char *buf = 0;
+            {
+                scoped_lock lk( sharedMutex );
+                if ( ! shared[c].empty() ) {
+                    buf = shared[c].back();
+                    shared[c].pop_back();
+                    sharedBytes -= classSize( c );
+                }
+            }
+            if ( buf ) {
+                stats.sharedHits++;
+                return buf;
+            }
+            size = classSize( c );
+        }
+        else {
+            stats.oversize++;
+        }
+
+        stats.mallocs++;
+        Header *h = (Header*)malloc( sizeof(Header) + size );
+        h->sizeClass = c;
+        h->size = size;
+        return (char*)( h + 1 );
+    }
+
+    char* BufferPool::grow( char *buf , int oldSize , int newSize ) {
+        if ( buf && capacity( buf ) >= newSize )
+            return buf;
+        char *n = get( newSize );
+        if ( buf ) {
+            memcpy( n , buf , oldSize );
+            release( buf );
+        }
+        return n;
+    }
+
+    void BufferPool::release( char *buf ) {
+        if ( ! buf )
+            return;
+        stats.releases++;
+
+        int c = header( buf )->sizeClass;
+        if ( c < 0 ) {
+            stats.frees++;
+            free( header( buf ) );
+            return;
+        }
+
+        if ( classSize( c ) <= MaxThreadCachedSize ) {
+            ThreadCache *tc = threadCache.get();
+            if ( ! tc ) {
+                tc = new ThreadCache();
+                threadCache.reset( tc );
+            }
+            if ( tc->bytes + classSize( c ) <= MaxThreadCachedBytes ) {
+                tc->buffers[c].push_back( buf );
+                tc->bytes += classSize( c );
+                return;
+            }
+        }
+
+        sharedRelease( buf , c );
+    }
+
+    int BufferPool::capacity( const char *buf ) {
+        return header( buf )->size;
+    }
+
+    void BufferPool::appendStats( BSONObjBuilder& b ) const {
+        b.appendNumber( "gets" , (long long)stats.gets.get() );
+        b.appendNumber( "threadCacheHits" , (long long)stats.threadHits.get() );
+        b.appendNumber( "sharedHits" , (long long)stats.sharedHits.get() );
+        b.appendNumber( "mallocs" , (long long)stats.mallocs.get() );
+        b.appendNumber( "oversize" , (long long)stats.oversize.get() );
+        b.appendNumber( "releases" , (long long)stats.releases.get() );
+        b.appendNumber( "frees" , (long long)stats.frees.get() );
+        scoped_lock lk( sharedMutex );
+        b.appendNumber( "sharedBytes" , sharedBytes );
+    }
+
+} // namespace mongo
@@ -0,0 +1,57 @@
+// buffer_pool.h
+
+/*    Copyright 2009 10gen Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include "../bson/util/builder.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+
+    /**
+     * Recycles the buffers messages are received into and replies are built in, so a busy server
+     * isn't malloc()ing and free()ing a buffer of up to several MB for every request.
+     *
+     * Buffers come in power of 2 size classes from 1KB to 8MB, bigger ones go straight to malloc().
+     * Each thread keeps a few small buffers to itself so the common case takes no lock; all other
+     * free buffers are shared, up to MaxSharedBytes in total.
+     *
+     * A buffer from get() must be given back with release(), never free().
+     */
+    class BufferPool : public BufAllocator {
+    public:
+        enum { MinSize = 1024 , 
+               NumClasses = 14 ,                  // MinSize << 13 == 8MB
+               MaxThreadCachedSize = 16 * 1024 ,  // larger buffers are only cached in the shared pool
+               MaxThreadCachedBytes = 64 * 1024 , 
+               MaxSharedBytes = 64 * 1024 * 1024 };
+
+        /** @return a buffer of at least size bytes */
+        virtual char* get( int size );
+        virtual char* grow( char *buf , int oldSize , int newSize );
+        virtual void release( char *buf );
+
+        /** usable size of a buffer from get() */
+        static int capacity( const char *buf );
+
+        void appendStats( BSONObjBuilder& b ) const;
+    };
+
+    extern BufferPool bufferPool;
+
+} // namespace mongo
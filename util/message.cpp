@@ -29,6 +29,10 @@
 #include "../client/dbclient.h"
 #include "../util/time_support.h"
 
+#ifdef MONGO_ZLIB
+#include <zlib.h>
+#endif
+
 #ifndef _WIN32
 # ifndef __sunos__
 #  include <ifaddrs.h>
@@ -311,12 +315,15 @@ namespace mongo {
         ports.closeAll(mask);
     }
 
-    MessagingPort::MessagingPort(int _sock, const SockAddr& _far) : sock(_sock), piggyBackData(0), _bytesIn(0), _bytesOut(0), farEnd(_far), _timeout(), tag(0) {
+    MessagingPort::MessagingPort(int _sock, const SockAddr& _far) : sock(_sock), piggyBackData(0), _bytesIn(0), _bytesOut(0), 
+        _compress(false), _compressedIn(0), _uncompressedIn(0), _compressedOut(0), _uncompressedOut(0),
+        _partialLen(0), _partialHave(0), _partial(0), farEnd(_far), _timeout(), tag(0) {
         _logLevel = 0;
         ports.insert(this);
     }
 
-    MessagingPort::MessagingPort( double timeout, int ll ) : _bytesIn(0), _bytesOut(0), tag(0) {
+    MessagingPort::MessagingPort( double timeout, int ll ) : _bytesIn(0), _bytesOut(0), 
+        _compress(false), _compressedIn(0), _uncompressedIn(0), _compressedOut(0), _uncompressedOut(0), _partialLen(0), _partialHave(0), _partial(0), tag(0) {
         _logLevel = ll;
         ports.insert(this);
         sock = -1;
@@ -334,6 +341,8 @@ namespace mongo {
     MessagingPort::~MessagingPort() {
         if ( piggyBackData )
             delete( piggyBackData );
+        if ( _partial )
+            bufferPool.release( (char*)_partial );
         shutdown();
         ports.erase(this);
     }
@@ -424,21 +433,14 @@ namespace mongo {
                 
                 if ( len == 542393671 ){
                     // an http GET
-                    log(_logLevel) << "looks like you're trying to access db over http on native driver port.  please add 1000 for webserver" << endl;
-                    string msg = "You are trying to access MongoDB on the native driver port. For http diagnostic access, add 1000 to the port number\n";
-                    stringstream ss;
-                    ss << "HTTP/1.0 200 OK\r\nConnection: close\r\nContent-Type: text/plain\r\nContent-Length: " << msg.size() << "\r\n\r\n" << msg;
-                    string s = ss.str();
-                    send( s.c_str(), s.size(), "http" );
+                    sendHttpNotice();
                     return false;
                 }
                 log(0) << "recv(): message len " << len << " is too large" << len << endl;
                 return false;
             }
             
-            int z = (len+1023)&0xfffffc00;
-            assert(z>=len);
-            MsgData *md = (MsgData *) malloc(z);
+            MsgData *md = (MsgData *) bufferPool.get(len);
             assert(md);
             md->len = len;
             
@@ -448,12 +450,14 @@ namespace mongo {
             try {
                 recv( p, left );
             } catch (...) {
-                free(md);
+                bufferPool.release( (char*)md );
                 throw;
             }
             
             _bytesIn += len;
-            m.setData(md, true);
+            if ( md->operation() == dbCompressed )
+                md = decompress( md );
+            m.setData(md, true, true);
             return true;
             
         } catch ( const SocketException & e ) {
@@ -463,6 +467,75 @@ namespace mongo {
         }
     }
     
+    void MessagingPort::sendHttpNotice() {
+        log(_logLevel) << "looks like you're trying to access db over http on native driver port.  please add 1000 for webserver" << endl;
+        string msg = "You are trying to access MongoDB on the native driver port. For http diagnostic access, add 1000 to the port number\n";
+        stringstream ss;
+        ss << "HTTP/1.0 200 OK\r\nConnection: close\r\nContent-Type: text/plain\r\nContent-Length: " << msg.size() << "\r\n\r\n" << msg;
+        string s = ss.str();
+        send( s.c_str(), s.size(), "http" );
+    }
+
+#if !defined(_WIN32)
+    bool MessagingPort::recvNonBlocking(Message& m) {
+        while ( 1 ) {
+            char *buf;
+            int want;
+            if ( _partialHave < 4 ) {
+                buf = (char *) &_partialLen + _partialHave;
+                want = 4 - _partialHave;
+            }
+            else {
+                buf = (char *) _partial + _partialHave;
+                want = _partialLen - _partialHave;
+            }
+
+            int ret = ::recv( sock , buf , want , portRecvFlags | MSG_DONTWAIT );
+            if ( ret == 0 ) {
+                log(3) << "MessagingPort recvNonBlocking() conn closed? " << farEnd.toString() << endl;
+                throw SocketException( SocketException::CLOSED );
+            }
+            if ( ret < 0 ) {
+                int e = errno;
+                if ( e == EAGAIN || e == EWOULDBLOCK || e == EINTR )
+                    return false;
+                log(_logLevel) << "MessagingPort recvNonBlocking() " << errnoWithDescription(e) << " " << farEnd.toString() << endl;
+                throw SocketException( SocketException::RECV_ERROR );
+            }
+            _partialHave += ret;
+
+            if ( _partialHave == 4 && ! _partial ) {
+                if ( _partialLen < 16 || _partialLen > 48000000 ) { // see recv()
+                    if ( _partialLen == -1 ) {
+                        unsigned foo = 0x10203040;
+                        send( (char *) &foo, 4, "endian" );
+                        _partialHave = 0;
+                        continue;
+                    }
+                    if ( _partialLen == 542393671 )
+                        sendHttpNotice();
+                    else
+                        log(0) << "recvNonBlocking(): message len " << _partialLen << " is too large" << endl;
+                    throw SocketException( SocketException::RECV_ERROR );
+                }
+                _partial = (MsgData *) bufferPool.get(_partialLen);
+                assert(_partial);
+                _partial->len = _partialLen;
+            }
+            else if ( _partial && _partialHave == _partialLen ) {
+                _bytesIn += _partialLen;
+                MsgData *md = _partial;
+                _partial = 0;
+                _partialHave = 0;
+                if ( md->operation() == dbCompressed )
+                    md = decompress( md );
+                m.setData( md, true, true );
+                return true;
+            }
+        }
+    }
+#endif
+
     void MessagingPort::reply(Message& received, Message& response) {
         say(/*received.from, */response, received.header()->id);
     }
@@ -502,6 +575,13 @@ namespace mongo {
         toSend.header()->id = nextMessageId();
         toSend.header()->responseTo = responseTo;
 
+        if ( _compress ) {
+            if ( piggyBackData )
+                piggyBackData->flush();
+            sayCompressed( toSend );
+            return;
+        }
+
         if ( piggyBackData && piggyBackData->len() ) {
             mmm( log() << "*     have piggy back" << endl; )
             if ( ( piggyBackData->len() + toSend.header()->len ) > 1300 ) {
@@ -518,6 +598,167 @@ namespace mongo {
         toSend.send( *this, "say" );
     }
 
+    /* compressed envelope: a normal header with operation dbCompressed and the id/responseTo of the
+       original message, then a CompressedHeader, then the body of the original message (everything
+       after its header) compressed with the compressor named in the CompressedHeader.
+    */
+#pragma pack(1)
+    struct CompressedHeader {
+        int originalOp;
+        int uncompressedSize; // of the body, not counting the original header
+        char compressor;
+    };
+#pragma pack()
+
+    enum Compressor { CompressNone = 0 , CompressZlib = 1 };
+
+    // smaller bodies go in the envelope as is, they'd barely shrink
+    const int CompressMinBytes = 512;
+
+    bool compressionSupported() {
+#ifdef MONGO_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void MessagingPort::sayCompressed( Message& toSend ) {
+        vector< pair< const char *, int > > pieces;
+        toSend.buffers( pieces );
+        MsgData *orig = toSend.header();
+        const int bodyLen = orig->len - MsgDataHeaderSize;
+        const int envelopeHeader = MsgDataHeaderSize + sizeof( CompressedHeader );
+
+        char compressor = CompressNone;
+        int room = bodyLen;
+#ifdef MONGO_ZLIB
+        z_stream zs;
+        if ( bodyLen >= CompressMinBytes ) {
+            memset( &zs, 0, sizeof( zs ) );
+            if ( deflateInit( &zs, Z_DEFAULT_COMPRESSION ) == Z_OK ) {
+                compressor = CompressZlib;
+                room = max( room, (int) deflateBound( &zs, bodyLen ) );
+            }
+        }
+#endif
+
+        char *buf = bufferPool.get( envelopeHeader + room );
+        MsgData *env = (MsgData *) buf;
+        env->id = orig->id;
+        env->responseTo = orig->responseTo;
+        env->setOperation( dbCompressed );
+        CompressedHeader *ch = (CompressedHeader *) env->_data;
+        ch->originalOp = orig->operation();
+        ch->uncompressedSize = bodyLen;
+        char *out = buf + envelopeHeader;
+        int outLen = 0;
+
+        // the first piece starts with the header, which doesn't go in the envelope body
+        int skip = MsgDataHeaderSize;
+#ifdef MONGO_ZLIB
+        if ( compressor == CompressZlib ) {
+            zs.next_out = (Bytef *) out;
+            zs.avail_out = room;
+            int ret = Z_OK;
+            for( unsigned i = 0; i < pieces.size() && ret == Z_OK; i++ ) {
+                int n = pieces[i].second - skip;
+                zs.next_in = (Bytef *) pieces[i].first + skip;
+                zs.avail_in = n;
+                skip = 0;
+                if ( n > 0 )
+                    ret = deflate( &zs, Z_NO_FLUSH );
+            }
+            if ( ret == Z_OK )
+                ret = deflate( &zs, Z_FINISH );
+            outLen = zs.total_out;
+            deflateEnd( &zs );
+            if ( ret != Z_STREAM_END || outLen >= bodyLen ) {
+                // incompressible, send it as is
+                compressor = CompressNone;
+                skip = MsgDataHeaderSize;
+            }
+        }
+#endif
+        if ( compressor == CompressNone ) {
+            outLen = 0;
+            for( unsigned i = 0; i < pieces.size(); i++ ) {
+                int n = pieces[i].second - skip;
+                memcpy( out + outLen, pieces[i].first + skip, n );
+                outLen += n;
+                skip = 0;
+            }
+        }
+        ch->compressor = compressor;
+        env->len = envelopeHeader + outLen;
+
+        _uncompressedOut += orig->len;
+        _compressedOut += env->len;
+        try {
+            send( buf, env->len, "say" );
+        } catch (...) {
+            bufferPool.release( buf );
+            throw;
+        }
+        bufferPool.release( buf );
+    }
+
+    MsgData * MessagingPort::decompress( MsgData *md ) {
+        const int envelopeHeader = MsgDataHeaderSize + sizeof( CompressedHeader );
+        CompressedHeader *ch = (CompressedHeader *) md->_data;
+        int bodyLen = md->len >= envelopeHeader ? ch->uncompressedSize : -1;
+        if ( bodyLen < 0 || bodyLen > 48000000 - MsgDataHeaderSize ) {
+            log(0) << "recv(): bad compressed message from " << farEnd.toString() << endl;
+            bufferPool.release( (char*)md );
+            throw SocketException( SocketException::RECV_ERROR );
+        }
+
+        MsgData *out = (MsgData *) bufferPool.get( MsgDataHeaderSize + bodyLen );
+        out->len = MsgDataHeaderSize + bodyLen;
+        out->id = md->id;
+        out->responseTo = md->responseTo;
+        out->setOperation( ch->originalOp );
+
+        const char *in = md->_data + sizeof( CompressedHeader );
+        int inLen = md->len - envelopeHeader;
+        bool ok = false;
+        if ( ch->compressor == CompressNone ) {
+            ok = inLen == bodyLen;
+            if ( ok )
+                memcpy( out->_data, in, bodyLen );
+        }
+#ifdef MONGO_ZLIB
+        else if ( ch->compressor == CompressZlib ) {
+            uLongf n = bodyLen;
+            ok = uncompress( (Bytef *) out->_data, &n, (const Bytef *) in, inLen ) == Z_OK && (int) n == bodyLen;
+        }
+#endif
+
+        if ( !ok ) {
+            log(0) << "recv(): can't decompress message from " << farEnd.toString() 
+                   << " compressor:" << (int) ch->compressor << endl;
+            bufferPool.release( (char*)md );
+            bufferPool.release( (char*)out );
+            throw SocketException( SocketException::RECV_ERROR );
+        }
+
+        _compressedIn += md->len;
+        _uncompressedIn += out->len;
+        bufferPool.release( (char*)md );
+
+        // the other side speaks the envelope, answer in kind
+        _compress = true;
+        return out;
+    }
+
+    void MessagingPort::appendCompressionStats( BSONObjBuilder& b ) const {
+        b.appendBool( "enabled" , _compress );
+        b.appendNumber( "compressedBytesIn" , _compressedIn );
+        b.appendNumber( "uncompressedBytesIn" , _uncompressedIn );
+        b.appendNumber( "compressedBytesOut" , _compressedOut );
+        b.appendNumber( "uncompressedBytesOut" , _uncompressedOut );
+    }
+
     // sends all data or throws an exception    
     void MessagingPort::send( const char * data , int len, const char *context ) {
         _bytesOut += len;
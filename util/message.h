@@ -20,6 +20,7 @@
 #include "../util/sock.h"
 #include "../bson/util/atomic_int.h"
 #include "hostandport.h"
+#include "buffer_pool.h"
 
 namespace mongo {
 
@@ -28,6 +29,8 @@ namespace mongo {
     class Message;
     class MessagingPort;
     class PiggyBackData;
+    class BSONObjBuilder;
+    struct MsgData;
     typedef AtomicUInt MSGID;
 
     class Listener : boost::noncopyable {
@@ -110,6 +113,15 @@ namespace mongo {
            also, the Message data will go out of scope on the subsequent recv call.
         */
         bool recv(Message& m);
+
+#if !defined(_WIN32)
+        /* for event driven servers: read whatever has arrived without blocking, keeping a partial
+           message in the port between calls.  returns true once m holds a whole message.
+           throws SocketException when the connection is closed or unusable.
+        */
+        bool recvNonBlocking(Message& m);
+        int getSock() const { return sock; }
+#endif
         void reply(Message& received, Message& response, MSGID responseTo);
         void reply(Message& received, Message& response);
         bool call(Message& toSend, Message& response);
@@ -132,13 +144,37 @@ namespace mongo {
         void clearCounters() { _bytesIn = 0; _bytesOut = 0; }
         long long getBytesIn() const { return _bytesIn; }
         long long getBytesOut() const { return _bytesOut; }
+
+        /* send messages in the compressed envelope (see dbCompressed).  only turn this on once the
+           other side is known to understand it - a server turns it on by itself when it receives an
+           enveloped message. */
+        void setCompression( bool on ) { _compress = on; }
+        bool compressing() const { return _compress; }
+        /* bytes that went over the wire in compressed envelopes, and their size uncompressed */
+        void appendCompressionStats( BSONObjBuilder& b ) const;
     private:
+        void sayCompressed( Message& toSend );
+        MsgData * decompress( MsgData *md );
+
         int sock;
         PiggyBackData * piggyBackData;
 
         long long _bytesIn;
         long long _bytesOut;
 
+        void sendHttpNotice();
+
+        bool _compress;
+        long long _compressedIn;
+        long long _uncompressedIn;
+        long long _compressedOut;
+        long long _uncompressedOut;
+
+        // recvNonBlocking() state
+        int _partialLen;
+        int _partialHave;
+        MsgData * _partial;
+
     public:
         SockAddr farEnd;
         double _timeout;
@@ -161,11 +197,16 @@ namespace mongo {
         dbQuery = 2004,
         dbGetMore = 2005,
         dbDelete = 2006,
-        dbKillCursors = 2007
+        dbKillCursors = 2007,
+        dbCompressed = 2012 /* envelope around another message, see MessagingPort::setCompression() */
     };
 
     bool doesOpGetAResponse( int op );
 
+    /* true if this build can compress messages (see dbCompressed).
+       servers advertise it in isMaster as compression : [ "zlib" ] */
+    bool compressionSupported();
+
     inline const char * opToString( int op ){
         switch ( op ){
         case 0: return "none";
@@ -177,6 +218,7 @@ namespace mongo {
         case dbGetMore: return "getmore";
         case dbDelete: return "remove";
         case dbKillCursors: return "killcursors";
+        case dbCompressed: return "compressed";
         default: 
             PRINT(op);
             assert(0); 
@@ -193,6 +235,7 @@ namespace mongo {
         case dbQuery: 
         case dbGetMore: 
         case dbKillCursors: 
+        case dbCompressed:
             return false;
             
         case dbUpdate: 
@@ -276,12 +319,12 @@ struct OP_GETMORE : public MSGHEADER {
     class Message {
     public:
         // we assume here that a vector with initial size 0 does no allocation (0 is the default, but wanted to make it explicit).
-        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ) {}
+        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {}
         Message( void * data , bool freeIt ) :
-            _buf( 0 ), _data( 0 ), _freeIt( false ) {
+            _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {
             _setData( reinterpret_cast< MsgData* >( data ), freeIt );
         };
-        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ) { 
+        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) { 
             *this = r;
         }
         ~Message() {
@@ -350,36 +393,41 @@ struct OP_GETMORE : public MSGHEADER {
             }
             r._freeIt = false;
             _freeIt = true;
+            _pooled = r._pooled;
+            r._pooled = false;
             return *this;
         }
 
         void reset() {
             if ( _freeIt ) {
                 if ( _buf ) {
-                    free( _buf );
+                    freeBuf( (char*)_buf );
                 }
                 for( vector< pair< char *, int > >::const_iterator i = _data.begin(); i != _data.end(); ++i ) {
-                    free(i->first);
+                    freeBuf(i->first);
                 }
             }
             _buf = 0;
             _data.clear();
             _freeIt = false;
+            _pooled = false;
         }
 
         // use to add a buffer
         // assumes message will free everything
-        void appendData(char *d, int size) {
+        // pooled: d came from bufferPool.  all buffers of a message have to come from the same place
+        void appendData(char *d, int size, bool pooled = false) {
             if ( size <= 0 ) {
                 return;
             }
             if ( empty() ) {
                 MsgData *md = (MsgData*)d;
                 md->len = size; // can be updated later if more buffers added
-                _setData( md, true );
+                _setData( md, true, pooled );
                 return;
             }
             assert( _freeIt );
+            assert( _pooled == pooled );
             if ( _buf ) {
                 _data.push_back( make_pair( (char*)_buf, _buf->len ) );
                 _buf = 0;
@@ -389,9 +437,9 @@ struct OP_GETMORE : public MSGHEADER {
         }
         
         // use to set first buffer if empty
-        void setData(MsgData *d, bool freeIt) {
+        void setData(MsgData *d, bool freeIt, bool pooled = false) {
             assert( empty() );
-            _setData( d, freeIt );
+            _setData( d, freeIt, pooled );
         }
         void setData(int operation, const char *msgtxt) {
             setData(operation, msgtxt, strlen(msgtxt)+1);
@@ -410,6 +458,16 @@ struct OP_GETMORE : public MSGHEADER {
             return _freeIt;
         }
 
+        /* the pieces of the message in order, the first one starts with the header */
+        void buffers( vector< pair< const char *, int > >& out ) const {
+            if ( _buf ) {
+                out.push_back( make_pair( (const char*)_buf, _buf->len ) );
+                return;
+            }
+            for( MsgVec::const_iterator i = _data.begin(); i != _data.end(); ++i )
+                out.push_back( make_pair( (const char*)i->first, i->second ) );
+        }
+
         void send( MessagingPort &p, const char *context ) {
             if ( empty() ) {
                 return;
@@ -422,16 +480,24 @@ struct OP_GETMORE : public MSGHEADER {
         }
 
     private:
-        void _setData( MsgData *d, bool freeIt ) {
+        void _setData( MsgData *d, bool freeIt, bool pooled = false ) {
             _freeIt = freeIt;
+            _pooled = pooled;
             _buf = d;
         }
+        void freeBuf( char *d ) {
+            if ( _pooled )
+                bufferPool.release( d );
+            else
+                free( d );
+        }
         // if just one buffer, keep it in _buf, otherwise keep a sequence of buffers in _data
         MsgData * _buf;
         // byte buffer(s) - the first must contain at least a full MsgData unless using _buf for storage instead
         typedef vector< pair< char*, int > > MsgVec;
         MsgVec _data;
         bool _freeIt;
+        bool _pooled; // buffers are from bufferPool rather than malloc()
     };
 
     class SocketException : public DBException {
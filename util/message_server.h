@@ -38,8 +38,10 @@ namespace mongo {
         struct Options {
             int port;                   // port to bind to
             string ipList;             // addresses to bind to
+            int workerThreads;         // > 0 : serve connections from an epoll loop with this many workers
+                                       //   0 : a thread per connection
 
-            Options() : port(0), ipList(""){} 
+            Options() : port(0), ipList(""), workerThreads(0){} 
         };
 
         virtual ~MessageServer(){}
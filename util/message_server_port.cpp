@@ -24,6 +24,11 @@
 
 #include "../db/cmdline.h"
 #include "../db/stats/counters.h"
+#include "concurrency/thread_pool.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 namespace mongo {
 
@@ -73,6 +78,124 @@ namespace mongo {
             handler->disconnected( p.get() );
         }
 
+#if defined(__linux__)
+        /* event driven variant of threadRun: a single thread waits on all connections with epoll and
+           reads messages as their bytes arrive, whole messages are then processed by a fixed pool of
+           workers.  so an idle connection costs a socket and a small struct, not a thread and its stack.
+           connections are armed with EPOLLONESHOT, so only one thread owns a connection at any time
+           and its messages are processed one at a time, in order.
+        */
+        class EpollServer : boost::noncopyable {
+        public:
+            EpollServer( int nWorkers ) : _pool( nWorkers ) {
+                _epfd = epoll_create( 1024 );
+                massert( 13537 , (string)"epoll_create failed " + errnoWithDescription() , _epfd >= 0 );
+            }
+
+            void add( MessagingPort * p ) {
+                Conn * c = new Conn( p );
+                if ( ! arm( c , EPOLL_CTL_ADD ) )
+                    end( c );
+            }
+
+            void run() {
+                setThreadName( "epoll" );
+                const int MaxEvents = 256;
+                struct epoll_event events[MaxEvents];
+                while ( ! inShutdown() ) {
+                    int n = epoll_wait( _epfd , events , MaxEvents , 1000 );
+                    if ( n < 0 ) {
+                        int x = errno;
+                        if ( x != EINTR ) {
+                            log() << "epoll_wait failed " << errnoWithDescription(x) << endl;
+                            sleepmillis(10);
+                        }
+                        continue;
+                    }
+                    for ( int i=0; i<n; i++ )
+                        readable( (Conn*)events[i].data.ptr );
+                }
+            }
+
+        private:
+            struct Conn {
+                Conn( MessagingPort * p ) : port( p ) , ticket( &connTicketHolder ) , otherSide( p->farEnd.toString() ){}
+                auto_ptr<MessagingPort> port;
+                TicketHolderReleaser ticket;
+                string otherSide;
+                Message m;
+            };
+
+            bool arm( Conn * c , int op ) {
+                struct epoll_event e;
+                memset( &e , 0 , sizeof(e) );
+                e.events = EPOLLIN | EPOLLONESHOT;
+                e.data.ptr = c;
+                if ( epoll_ctl( _epfd , op , c->port->getSock() , &e ) == 0 )
+                    return true;
+                log() << "epoll_ctl failed " << errnoWithDescription() << " closing connection " << c->otherSide << endl;
+                return false;
+            }
+
+            // epoll thread.  never blocks on the socket
+            void readable( Conn * c ) {
+                try {
+                    if ( ! c->port->recvNonBlocking( c->m ) ) {
+                        if ( arm( c , EPOLL_CTL_MOD ) )
+                            return;
+                    }
+                    else {
+                        _pool.schedule( &EpollServer::process , this , c );
+                        return;
+                    }
+                }
+                catch ( const SocketException& e ){
+                    if ( e._type == SocketException::CLOSED ) {
+                        if( !cmdLine.quiet )
+                            log() << "end connection " << c->otherSide << endl;
+                    }
+                    else {
+                        log() << "unclean socket shutdown from: " << c->otherSide << endl;
+                    }
+                }
+                end( c );
+            }
+
+            // worker thread
+            void process( Conn * c ) {
+                MessagingPort * p = c->port.get();
+                try {
+                    handler->process( c->m , p );
+                    networkCounter.hit( p->getBytesIn() , p->getBytesOut() );
+                    p->clearCounters();
+                    c->m.reset();
+                    if ( arm( c , EPOLL_CTL_MOD ) )
+                        return;
+                }
+                catch ( const SocketException& ){
+                    log() << "unclean socket shutdown from: " << c->otherSide << endl;
+                }
+                catch ( const std::exception& e ){
+                    problem() << "uncaught exception (" << e.what() << ")(" << demangleName( typeid(e) ) <<") in PortMessageServer worker, closing connection" << endl;
+                }
+                catch ( ... ){
+                    problem() << "uncaught exception in PortMessageServer worker, closing connection" << endl;
+                }
+                end( c );
+            }
+
+            void end( Conn * c ) {
+                epoll_ctl( _epfd , EPOLL_CTL_DEL , c->port->getSock() , 0 );
+                handler->disconnected( c->port.get() );
+                c->port->shutdown();
+                delete c;
+            }
+
+            int _epfd;
+            ThreadPool _pool;
+        };
+#endif
+
     }
 
     class PortMessageServer : public MessageServer , public Listener {
@@ -82,6 +205,15 @@ namespace mongo {
             
             uassert( 10275 ,  "multiple PortMessageServer not supported" , ! pms::handler );
             pms::handler = handler;
+
+            if ( opts.workerThreads > 0 ) {
+#if defined(__linux__)
+                log() << "serving connections with " << opts.workerThreads << " worker threads" << endl;
+                _epoll.reset( new pms::EpollServer( opts.workerThreads ) );
+#else
+                log() << "warning: workerThreads is only supported on linux, using a thread per connection" << endl;
+#endif
+            }
         }
         
         virtual void accepted(MessagingPort * p) {
@@ -97,6 +229,13 @@ namespace mongo {
                 return;
             }
 
+#if defined(__linux__)
+            if ( _epoll.get() ) {
+                _epoll->add( p );
+                return;
+            }
+#endif
+
             try {
                 boost::thread thr( boost::bind( &pms::threadRun , p ) );
             }
@@ -115,9 +254,18 @@ namespace mongo {
         }
 
         void run(){
+#if defined(__linux__)
+            if ( _epoll.get() )
+                boost::thread thr( boost::bind( &pms::EpollServer::run , _epoll.get() ) );
+#endif
             initAndListen();
         }
 
+    private:
+#if defined(__linux__)
+        auto_ptr<pms::EpollServer> _epoll;
+#endif
+
     };
 
 
@@ -136,7 +136,13 @@ namespace mongo {
 
     };
 
-    void printMemInfo( const char * where );    
+    void printMemInfo( const char * where );
+
+    /** hint to the os that the given ranges of mapped memory will be read soon, so the
+        page faults can be taken asynchronously.  ranges are sorted and adjacent pages merged,
+        so passing many small ranges is fine.  no-op where not supported.
+    */
+    void prefetchRanges( vector< pair<const char*,size_t> >& ranges );    
 
     typedef MemoryMappedFile MMF;
 
@@ -99,6 +99,39 @@ namespace mongo {
         return view;
     }
     
+    void prefetchRanges( vector< pair<const char*,size_t> >& ranges ){
+#if defined(__sunos__)
+        // madvise not supported on solaris yet, see above
+#else
+        if ( ranges.empty() )
+            return;
+
+        static const size_t pageSize = sysconf( _SC_PAGESIZE );
+        sort( ranges.begin() , ranges.end() );
+
+        size_t start = 0;
+        size_t end = 0;
+        for ( unsigned i=0; i<=ranges.size(); i++ ){
+            size_t s = 0;
+            size_t e = 0;
+            if ( i < ranges.size() ){
+                s = (size_t)ranges[i].first;
+                e = s + ranges[i].second;
+                s -= s % pageSize;
+                if ( end && s <= end ){
+                    end = max( end , e );
+                    continue;
+                }
+            }
+            if ( end && madvise( (void*)start , end - start , MADV_WILLNEED ) ){
+                log(1) << "prefetch: madvise failed " << errnoWithDescription() << endl;
+            }
+            start = s;
+            end = e;
+        }
+#endif
+    }
+
     void* MemoryMappedFile::testGetCopyOnWriteView(){
         void * x = mmap( NULL , len , PROT_READ | PROT_WRITE , MAP_PRIVATE , fd , 0 );
         assert( x );
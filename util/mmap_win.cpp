@@ -208,4 +208,8 @@ namespace mongo {
     void MemoryMappedFile::_lock() {}
     void MemoryMappedFile::_unlock() {}
 
+    void prefetchRanges( vector< pair<const char*,size_t> >& ranges ) {
+        // no equivalent of madvise( MADV_WILLNEED ) for mapped views here
+    }
+
 } 
@@ -72,8 +72,8 @@ namespace mongo {
                    &_flags, &_min_flt, &_cmin_flt, &_maj_flt, &_cmaj_flt,
                    &_utime, &_stime, &_cutime, &_cstime,
                    &_priority, &_nice,
-                   &_alarm,
                    &_nlwp,
+                   &_alarm,
                    &_start_time,
                    &_vsize,
                    &_rss,
@@ -154,9 +154,10 @@ namespace mongo {
         long _nice;
         
         long _nlwp; // %ld
-        // The time in jiffies before the next SIGALRM is sent to the process due to an interval timer.
+        // The number of threads in the process.
         
         unsigned long _alarm;
+        // The time in jiffies before the next SIGALRM is sent to the process due to an interval timer.
         
         unsigned long _start_time; // %lu
         // The time in jiffies the process started after system boot.
@@ -217,6 +218,7 @@ namespace mongo {
 
         LinuxProc p(_pid);
         info.append("page_faults", (int)p._maj_flt);
+        info.append("threads", (int)p._nlwp);
     }
 
     bool ProcessInfo::blockCheckSupported(){
@@ -261,6 +261,11 @@ namespace mongo {
             scoped_lock lk( _mutex );
             _socketPaths->insert( path );
         }
+        /** @return true if we are listening on the unix domain socket at path */
+        bool hasPath( const string& path ){
+            scoped_lock lk( _mutex );
+            return _socketPaths->count( path ) > 0;
+        }
         void remove( int sock ){
             scoped_lock lk( _mutex );
             _sockets->erase( sock );